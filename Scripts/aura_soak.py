@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# Copyright Adam Thomas
+"""
+Network soak test: launches a -nullrhi dedicated server and N headless -AuraBot clients on this machine,
+waits for them to finish and summarises the -AuraSoakCsv stats the server wrote.
+
+    python Scripts/aura_soak.py --editor "C:/UE_5.2/Engine/Binaries/Win64/UnrealEditor.exe" --clients 8 --duration 300
+
+The server writes Server.csv, Server_Connections.csv and Server_RPCs.csv to the output directory, each client Client_<N>*.csv.
+--history appends one summary row per run so bytes per player can be tracked as features land.
+Running once with the editor's -server mode and once with --server-exe pointing at a packaged AuraServer compares
+the server memory and frame time with and without the cosmetic code compiled in.
+--enemies spawns a crowd on the server and --no-repgraph falls back to the default relevancy, so running
+
+    python Scripts/aura_soak.py ... --clients 8 --enemies 400 --enemy-class <Path> --label repgraph --history Soak.csv
+    python Scripts/aura_soak.py ... --clients 8 --enemies 400 --enemy-class <Path> --label default --history Soak.csv --no-repgraph
+
+compares the server replication time (ReplicationMs) of UAuraReplicationGraph against the default.
+In the same way --pickups fills the map with effect actors and --no-dormancy keeps them awake, to measure what
+their net dormancy saves. --instanced-pickups adds the same field to the map's AuraPickupManager instead, to compare
+memory (UsedPhysicalMB, UObjects, Actors) and frame time against an actor per pickup.
+"""
+
+import argparse
+import csv
+import datetime
+import os
+import subprocess
+import sys
+import time
+
+
+def project_file():
+    return os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Aura.uproject"))
+
+
+def launch(args, extra, log_name, executable=None):
+    # Packaged targets such as AuraServer know their project, the editor needs to be told
+    command = [executable] if executable else [args.editor, project_file()]
+    command += extra + ["-nullrhi", "-nosound", "-unattended", "-nosplash", "-log",
+                                                       "-abslog=" + os.path.join(args.output, log_name)]
+    return subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(int(fraction * len(ordered)), len(ordered) - 1)]
+
+
+def mean(values):
+    return sum(values) / len(values) if values else 0.0
+
+
+def summarise(args):
+    rows = []
+    with open(os.path.join(args.output, "Server.csv"), newline="") as server_csv:
+        rows = [row for row in csv.DictReader(server_csv)]
+
+    # Only rows with every bot connected, connecting and leaving skew the averages
+    steady = [row for row in rows if int(row["Connections"]) >= args.clients] or rows
+    frame_ms = [float(row["FrameMs"]) for row in steady]
+    game_thread_ms = [float(row["GameThreadMs"]) for row in steady]
+    replication_ms = [float(row["ReplicationMs"]) for row in steady]
+    bytes_per_connection = [float(row["OutBytesPerConnection"]) for row in steady]
+    rpcs = [float(row["RPCsPerSecond"]) for row in steady]
+    gc_ms = [float(row["GCMs"]) for row in steady]
+
+    summary = {
+        "Date": datetime.datetime.now().isoformat(timespec="seconds"),
+        "Label": args.label,
+        "Clients": args.clients,
+        "Enemies": args.enemies,
+        "Pickups": args.pickups,
+        "InstancedPickups": args.instanced_pickups,
+        "Samples": len(steady),
+        "FrameMsMean": round(mean(frame_ms), 3),
+        "FrameMsP95": round(percentile(frame_ms, 0.95), 3),
+        "GameThreadMsMean": round(mean(game_thread_ms), 3),
+        "GameThreadMsP95": round(percentile(game_thread_ms, 0.95), 3),
+        "ReplicationMsMean": round(mean(replication_ms), 3),
+        "ReplicationMsP95": round(percentile(replication_ms, 0.95), 3),
+        "OutBytesPerPlayerMean": round(mean(bytes_per_connection), 1),
+        "OutBytesPerPlayerP95": round(percentile(bytes_per_connection, 0.95), 1),
+        "RPCsPerSecondMean": round(mean(rpcs), 1),
+        "GCs": sum(int(row["GCs"]) for row in steady),
+        "GCMsTotal": round(sum(gc_ms), 1),
+        "UsedPhysicalMBMax": max((int(row["UsedPhysicalMB"]) for row in steady), default=0),
+        "UObjectsMax": max((int(row["UObjects"]) for row in steady), default=0),
+        "ActorsMax": max((int(row["Actors"]) for row in steady), default=0),
+    }
+
+    for key, value in summary.items():
+        print("%-24s %s" % (key, value))
+
+    rpc_path = os.path.join(args.output, "Server_RPCs.csv")
+    if os.path.exists(rpc_path):
+        print("\nTop server RPCs")
+        with open(rpc_path, newline="") as rpc_csv:
+            for row in list(csv.DictReader(rpc_csv))[:10]:
+                print("  %-48s %10s %10s/s" % (row["Function"], row["Count"], row["PerSecond"]))
+
+    if args.history:
+        exists = os.path.exists(args.history)
+        with open(args.history, "a", newline="") as history_csv:
+            writer = csv.DictWriter(history_csv, fieldnames=list(summary.keys()))
+            if not exists:
+                writer.writeheader()
+            writer.writerow(summary)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--editor", required=True, help="UnrealEditor executable")
+    parser.add_argument("--server-exe", help="Packaged AuraServer executable, run instead of the editor's -server mode")
+    parser.add_argument("--map", default="/Game/Maps/Dungeon")
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--duration", type=int, default=300, help="Seconds the server runs for")
+    parser.add_argument("--port", type=int, default=7777)
+    parser.add_argument("--output", default=os.path.join("Saved", "Soak", datetime.datetime.now().strftime("%Y%m%d-%H%M%S")))
+    parser.add_argument("--history", help="CSV to append the run summary to")
+    parser.add_argument("--label", default="", help="Recorded in the history, e.g. a commit or feature name")
+    parser.add_argument("--enemies", type=int, default=0, help="Enemies the server spawns around the player start")
+    parser.add_argument("--enemy-class", help="Enemy Blueprint class path for --enemies, e.g. /Game/Blueprints/Character/Goblin_Spear/BP_Goblin_Spear.BP_Goblin_Spear_C")
+    parser.add_argument("--no-repgraph", action="store_true", help="Run the server without the Aura replication graph")
+    parser.add_argument("--pickups", type=int, default=0, help="Effect actors the server spawns on a grid around the player start")
+    parser.add_argument("--pickup-class", default="/Game/Blueprints/Actor/Potion/BP_HealthPotion.BP_HealthPotion_C")
+    parser.add_argument("--instanced-pickups", action="store_true", help="Add --pickups to the map's AuraPickupManager instead of spawning actors")
+    parser.add_argument("--no-dormancy", action="store_true", help="Keep effect actors awake, Aura.EffectActor.Dormancy=0")
+    parser.add_argument("--connect-delay", type=float, default=15.0, help="Seconds to let the server load before clients join")
+    args = parser.parse_args()
+
+    args.output = os.path.abspath(args.output)
+    os.makedirs(args.output, exist_ok=True)
+
+    server_args = [args.map, "-server", "-port=%d" % args.port,
+                   "-AuraSoakCsv=" + os.path.join(args.output, "Server.csv"),
+                   "-AuraSoakDuration=%d" % args.duration]
+    if args.enemies > 0:
+        if not args.enemy_class:
+            parser.error("--enemies needs --enemy-class")
+        server_args += ["-AuraSpawnEnemies=%d" % args.enemies, "-AuraSpawnEnemyClass=" + args.enemy_class]
+    if args.pickups > 0 and args.instanced_pickups:
+        server_args.append("-AuraSpawnInstancedPickups=%d" % args.pickups)
+    elif args.pickups > 0:
+        server_args += ["-AuraSpawnPickups=%d" % args.pickups, "-AuraSpawnPickupClass=" + args.pickup_class]
+    if args.no_dormancy:
+        server_args.append("-ini:Engine:[ConsoleVariables]:Aura.EffectActor.Dormancy=0")
+    if args.no_repgraph:
+        server_args.append("-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName=")
+
+    server = launch(args, server_args, "Server.log", args.server_exe)
+    time.sleep(args.connect_delay)
+
+    # Clients leave shortly before the server so it records their disconnects
+    client_duration = max(args.duration - args.connect_delay - 10, 10)
+    clients = []
+    for index in range(args.clients):
+        clients.append(launch(args, ["127.0.0.1:%d" % args.port, "-game", "-AuraBot", "-AuraBotSeed=%d" % (index + 1),
+                                     "-AuraSoakCsv=" + os.path.join(args.output, "Client_%d.csv" % index),
+                                     "-AuraSoakDuration=%d" % client_duration], "Client_%d.log" % index))
+
+    deadline = time.time() + args.duration + 120
+    for process in clients + [server]:
+        try:
+            process.wait(timeout=max(deadline - time.time(), 1))
+        except subprocess.TimeoutExpired:
+            print("Process %d did not exit in time, killing it" % process.pid, file=sys.stderr)
+            process.kill()
+
+    summarise(args)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -6,4 +6,7 @@
 
 #define CUSTOM_DEPTH_RED 250
 #define NET_FREQUENCY_VALUE 100.f
-#define ECC_Projectile ECollisionChannel::ECC_GameTraceChannel1
\ No newline at end of file
+#define ECC_Projectile ECollisionChannel::ECC_GameTraceChannel1
+
+// Health bars, VFX, audio, dissolves and damage numbers, compiled out of dedicated server builds
+#define WITH_AURA_COSMETICS (!UE_SERVER)
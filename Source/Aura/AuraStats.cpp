@@ -0,0 +1,117 @@
+#include "AuraStats.h"
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+
+DEFINE_STAT(STAT_AuraExecCalcDamage);
+DEFINE_STAT(STAT_AuraPostGameplayEffectExecute);
+DEFINE_STAT(STAT_AuraDebuffCreation);
+DEFINE_STAT(STAT_AuraDamageExecutions);
+DEFINE_STAT(STAT_AuraDebuffsApplied);
+DEFINE_STAT(STAT_AuraCursorTrace);
+DEFINE_STAT(STAT_AuraAutoRun);
+DEFINE_STAT(STAT_AuraProjectileOverlap);
+DEFINE_STAT(STAT_AuraProjectilesSpawned);
+DEFINE_STAT(STAT_AuraLiveProjectiles);
+DEFINE_STAT(STAT_AuraPickupOverlap);
+DEFINE_STAT(STAT_AuraInstancedPickups);
+DEFINE_STAT(STAT_AuraWidgetBroadcast);
+DEFINE_STAT(STAT_AuraWidgetBroadcasts);
+
+UE_TRACE_CHANNEL_DEFINE(AuraChannel);
+
+UE_TRACE_EVENT_BEGIN(Aura, EffectApplied)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, SourceId)
+	UE_TRACE_EVENT_FIELD(uint32, TargetId)
+	UE_TRACE_EVENT_FIELD(float, Level)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Source)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Target)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Effect)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, AssetTags)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Aura, DamageResolved)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, SourceId)
+	UE_TRACE_EVENT_FIELD(uint32, TargetId)
+	UE_TRACE_EVENT_FIELD(float, Damage)
+	UE_TRACE_EVENT_FIELD(bool, BlockedHit)
+	UE_TRACE_EVENT_FIELD(bool, CriticalHit)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Source)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Target)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Aura, AbilityActivated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, OwnerId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Owner)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Ability)
+UE_TRACE_EVENT_END()
+
+namespace AuraTrace
+{
+	static uint32 GetId(const UAbilitySystemComponent* ASC)
+	{
+		return ASC ? ASC->GetUniqueID() : 0;
+	}
+
+	static FString GetName(const UAbilitySystemComponent* ASC)
+	{
+		const AActor* Avatar = ASC ? ASC->GetAvatarActor_Direct() : nullptr;
+		return Avatar ? Avatar->GetName() : FString();
+	}
+}
+
+void FAuraTrace::EffectApplied(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, const FGameplayEffectSpec& Spec)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(AuraChannel)) return;
+
+	const FString Source = AuraTrace::GetName(SourceASC);
+	const FString Target = AuraTrace::GetName(TargetASC);
+	const FString Effect = GetNameSafe(Spec.Def);
+	FGameplayTagContainer AssetTags;
+	Spec.GetAllAssetTags(AssetTags);
+	const FString AssetTagString = AssetTags.ToStringSimple();
+
+	UE_TRACE_LOG(Aura, EffectApplied, AuraChannel)
+		<< EffectApplied.Cycle(FPlatformTime::Cycles64())
+		<< EffectApplied.SourceId(AuraTrace::GetId(SourceASC))
+		<< EffectApplied.TargetId(AuraTrace::GetId(TargetASC))
+		<< EffectApplied.Level(Spec.GetLevel())
+		<< EffectApplied.Source(*Source, Source.Len())
+		<< EffectApplied.Target(*Target, Target.Len())
+		<< EffectApplied.Effect(*Effect, Effect.Len())
+		<< EffectApplied.AssetTags(*AssetTagString, AssetTagString.Len());
+}
+
+void FAuraTrace::DamageResolved(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, float Damage, bool bBlockedHit, bool bCriticalHit)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(AuraChannel)) return;
+
+	const FString Source = AuraTrace::GetName(SourceASC);
+	const FString Target = AuraTrace::GetName(TargetASC);
+
+	UE_TRACE_LOG(Aura, DamageResolved, AuraChannel)
+		<< DamageResolved.Cycle(FPlatformTime::Cycles64())
+		<< DamageResolved.SourceId(AuraTrace::GetId(SourceASC))
+		<< DamageResolved.TargetId(AuraTrace::GetId(TargetASC))
+		<< DamageResolved.Damage(Damage)
+		<< DamageResolved.BlockedHit(bBlockedHit)
+		<< DamageResolved.CriticalHit(bCriticalHit)
+		<< DamageResolved.Source(*Source, Source.Len())
+		<< DamageResolved.Target(*Target, Target.Len());
+}
+
+void FAuraTrace::AbilityActivated(const UAbilitySystemComponent* ASC, const FGameplayTag& AbilityTag)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(AuraChannel)) return;
+
+	const FString Owner = AuraTrace::GetName(ASC);
+	const FString Ability = AbilityTag.ToString();
+
+	UE_TRACE_LOG(Aura, AbilityActivated, AuraChannel)
+		<< AbilityActivated.Cycle(FPlatformTime::Cycles64())
+		<< AbilityActivated.OwnerId(AuraTrace::GetId(ASC))
+		<< AbilityActivated.Owner(*Owner, Owner.Len())
+		<< AbilityActivated.Ability(*Ability, Ability.Len());
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+class UAbilitySystemComponent;
+struct FGameplayEffectSpec;
+struct FGameplayTag;
+
+DECLARE_STATS_GROUP(TEXT("Aura"), STATGROUP_Aura, STATCAT_Advanced);
+
+// Combat
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ExecCalc Damage"), STAT_AuraExecCalcDamage, STATGROUP_Aura, AURA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PostGameplayEffectExecute"), STAT_AuraPostGameplayEffectExecute, STATGROUP_Aura, AURA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Debuff Creation"), STAT_AuraDebuffCreation, STATGROUP_Aura, AURA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Damage Executions"), STAT_AuraDamageExecutions, STATGROUP_Aura, AURA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Debuffs Applied"), STAT_AuraDebuffsApplied, STATGROUP_Aura, AURA_API);
+
+// Player input
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cursor Trace"), STAT_AuraCursorTrace, STATGROUP_Aura, AURA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Auto Run"), STAT_AuraAutoRun, STATGROUP_Aura, AURA_API);
+
+// Projectiles
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Overlap"), STAT_AuraProjectileOverlap, STATGROUP_Aura, AURA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Projectiles Spawned"), STAT_AuraProjectilesSpawned, STATGROUP_Aura, AURA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Projectiles"), STAT_AuraLiveProjectiles, STATGROUP_Aura, AURA_API);
+
+// Pickups
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pickup Overlap"), STAT_AuraPickupOverlap, STATGROUP_Aura, AURA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Instanced Pickups"), STAT_AuraInstancedPickups, STATGROUP_Aura, AURA_API);
+
+// UI
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Widget Broadcast"), STAT_AuraWidgetBroadcast, STATGROUP_Aura, AURA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Widget Broadcasts"), STAT_AuraWidgetBroadcasts, STATGROUP_Aura, AURA_API);
+
+UE_TRACE_CHANNEL_EXTERN(AuraChannel, AURA_API);
+
+/**
+ * Structured combat events on the Aura trace channel, enable with -trace=default,aura.
+ * Each event names the source and target ASC's avatar so spikes in Insights can be attributed to abilities and effects.
+ */
+struct AURA_API FAuraTrace
+{
+	static void EffectApplied(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, const FGameplayEffectSpec& Spec);
+	static void DamageResolved(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, float Damage, bool bBlockedHit, bool bCriticalHit);
+	static void AbilityActivated(const UAbilitySystemComponent* ASC, const FGameplayTag& AbilityTag);
+};
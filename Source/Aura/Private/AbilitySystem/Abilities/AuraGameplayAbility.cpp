@@ -3,6 +3,9 @@
 
 #include "AbilitySystem/Abilities/AuraGameplayAbility.h"
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "GameplayEffect.h"
 
 FString UAuraGameplayAbility::GetDescription(int32 Level)
 {
@@ -19,6 +22,31 @@ FString UAuraGameplayAbility::GetLockedDescription(int32 Level)
     return FString::Printf(TEXT("<Default>Spell Locked Until Level: %d</>"), Level);
 }
 
+bool UAuraGameplayAbility::CheckCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, FGameplayTagContainer* OptionalRelevantTags) const
+{
+    // Mana regenerates analytically, so a plain mana cost is checked against the regenerated value without settling it.
+    // Applying the cost settles Mana in PreGameplayEffectExecute
+    const UGameplayEffect* CostEffect = GetCostGameplayEffect();
+    if (ActorInfo && ActorInfo->AbilitySystemComponent.IsValid() && CostEffect && CostEffect->Modifiers.Num() == 1)
+    {
+        const FGameplayModifierInfo& Mod = CostEffect->Modifiers[0];
+        const UAuraAttributeSet* AuraAttributeSet = ActorInfo->AbilitySystemComponent->GetSet<UAuraAttributeSet>();
+        float Magnitude = 0.f;
+        if (AuraAttributeSet && Mod.Attribute == UAuraAttributeSet::GetManaAttribute() && Mod.ModifierOp == EGameplayModOp::Additive
+            && Mod.ModifierMagnitude.GetStaticMagnitudeIfPossible(GetAbilityLevel(Handle, ActorInfo), Magnitude))
+        {
+            if (AuraAttributeSet->GetSettledMana() + Magnitude >= 0.f) return true;
+
+            if (OptionalRelevantTags)
+            {
+                OptionalRelevantTags->AddTag(UAbilitySystemGlobals::Get().ActivateFailCostTag);
+            }
+            return false;
+        }
+    }
+    return Super::CheckCost(Handle, ActorInfo, OptionalRelevantTags);
+}
+
 float UAuraGameplayAbility::GetManaCost(float InLevel) const
 {
     float ManaCost = 0.f;
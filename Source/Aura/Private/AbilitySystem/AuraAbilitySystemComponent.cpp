@@ -8,11 +8,44 @@
 #include "AbilitySystem/Data/AbilityInfo.h"
 #include "AbilitySystem/AuraAbilitySystemLibrary.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystem/AuraRandomStream.h"
+#include "Aura/AuraStats.h"
+
+static TAutoConsoleVariable<float> CVarAuraHitReactCooldown(
+	TEXT("Aura.HitReact.Cooldown"),
+	0.25f,
+	TEXT("Minimum seconds between two hit react activations on the same character."));
+
+static TAutoConsoleVariable<int32> CVarAuraRollsSeed(
+	TEXT("Aura.Rolls.Seed"),
+	0,
+	TEXT("Non-zero gives every ability system component a roll seed derived from this value and its owner's name, making damage rolls reproducible between runs."));
 
 void UAuraAbilitySystemComponent::AbilityActorInfoSet()
 {
 	OnGameplayEffectAppliedDelegateToSelf.AddUObject(this, &UAuraAbilitySystemComponent::ClientEffectApplied);
+	OnGameplayEffectAppliedDelegateToSelf.AddUObject(this, &UAuraAbilitySystemComponent::TraceEffectApplied);
 
+	if (IsOwnerActorAuthoritative() && RollSeedBase == 0)
+	{
+		const int32 FixedSeed = CVarAuraRollsSeed.GetValueOnGameThread();
+		RollSeedBase = FixedSeed != 0
+			? FAuraRandomStream::MixSeed(static_cast<uint64>(FixedSeed), GetTypeHash(GetOwner()->GetFName()))
+			: FAuraRandomStream::MixSeed(FPlatformTime::Cycles64(), reinterpret_cast<UPTRINT>(this));
+	}
+}
+
+uint64 UAuraAbilitySystemComponent::NextRollSeed()
+{
+	// Zero in the context means unseeded
+	const uint64 Seed = FAuraRandomStream::MixSeed(RollSeedBase, ++RollCounter);
+	return Seed != 0 ? Seed : 1;
+}
+
+void UAuraAbilitySystemComponent::SetRollSeedBase(uint64 InRollSeedBase)
+{
+	RollSeedBase = InRollSeedBase;
+	RollCounter = 0;
 }
 
 void UAuraAbilitySystemComponent::AddCharacterAbilities(const TArray<TSubclassOf<UGameplayAbility>>& StartupAbilities)
@@ -284,6 +317,22 @@ void UAuraAbilitySystemComponent::ClientEffectApplied_Implementation(UAbilitySys
 
 }
 
+void UAuraAbilitySystemComponent::TraceEffectApplied(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec,
+	FActiveGameplayEffectHandle ActiveEffectHandle)
+{
+	FAuraTrace::EffectApplied(EffectSpec.GetEffectContext().GetInstigatorAbilitySystemComponent(), this, EffectSpec);
+}
+
+void UAuraAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
+{
+	Super::NotifyAbilityActivated(Handle, Ability);
+
+	if (const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(Handle))
+	{
+		FAuraTrace::AbilityActivated(this, GetAbilityTagFromSpec(*AbilitySpec));
+	}
+}
+
 void UAuraAbilitySystemComponent::ClientUpdateAbilityStatus_Implementation(const FGameplayTag& AbilityTag, const FGameplayTag& StatusTag, int32 AbilityLevel)
 {
 	AbilityStatusChanged.Broadcast(AbilityTag, StatusTag, AbilityLevel);
@@ -352,3 +401,51 @@ bool UAuraAbilitySystemComponent::AbilityHasSlot(FGameplayAbilitySpec* Spec, con
 	}
     return false;
 }
+
+bool UAuraAbilitySystemComponent::TryActivateHitReact()
+{
+	// Coalesce every hit landing this frame, e.g. a volley or an AoE, into a single attempt
+	if (LastHitReactFrame == GFrameCounter) return false;
+	LastHitReactFrame = GFrameCounter;
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now - LastHitReactTime < CVarAuraHitReactCooldown.GetValueOnGameThread()) return false;
+
+	if (bHitReactHandleDirty)
+	{
+		CachedHitReactHandle = FGameplayAbilitySpecHandle();
+		for (const FGameplayAbilitySpec& AbilitySpec : GetActivatableAbilities())
+		{
+			if (AbilitySpec.Ability && AbilitySpec.Ability->AbilityTags.HasTagExact(FAuraGameplayTags::Get().Effects_HitReact))
+			{
+				CachedHitReactHandle = AbilitySpec.Handle;
+				break;
+			}
+		}
+		bHitReactHandleDirty = false;
+	}
+
+	if (!CachedHitReactHandle.IsValid()) return false;
+
+	const FGameplayAbilitySpec* HitReactSpec = FindAbilitySpecFromHandle(CachedHitReactHandle);
+	if (HitReactSpec == nullptr || HitReactSpec->IsActive()) return false;
+
+	if (TryActivateAbility(CachedHitReactHandle))
+	{
+		LastHitReactTime = Now;
+		return true;
+	}
+	return false;
+}
+
+void UAuraAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+	bHitReactHandleDirty = true;
+}
+
+void UAuraAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+	bHitReactHandleDirty = true;
+}
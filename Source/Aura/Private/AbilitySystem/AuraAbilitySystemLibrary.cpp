@@ -11,6 +11,9 @@
 #include "Player/AuraPlayerState.h"
 #include "UI/HUD/AuraHUD.h"
 #include "AuraAbilityTypes.h"
+#include "AbilitySystem/Snapshot/AuraAttributeSnapshotSubsystem.h"
+#include "AbilitySystem/Data/AuraCompiledCurveTable.h"
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
 
 bool UAuraAbilitySystemLibrary::MakeWidgetControllerParams(const UObject* WorldContextObject, FWidgetControllerParams& OutWCParams, AAuraHUD*& OutAuraHUD)
 {
@@ -81,11 +84,23 @@ void UAuraAbilitySystemLibrary::InitializeDefaultAttributes(const UObject* World
 
 	if (!CharacterClassInfo) return;
 
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	UAuraAttributeSnapshotSubsystem* SnapshotSubsystem = GameInstance ? GameInstance->GetSubsystem<UAuraAttributeSnapshotSubsystem>() : nullptr;
+	if (SnapshotSubsystem && SnapshotSubsystem->ApplySnapshot(ASC, CharacterClass, Level, CharacterClassInfo->SecondaryAttributes)) return;
+
+	// Only an ASC with nothing else applied gives values that are safe to share
+	const bool bCaptureSnapshot = SnapshotSubsystem && UAuraAttributeSnapshotSubsystem::IsEnabled() && ASC->GetNumActiveGameplayEffects() == 0;
+
 	FCharacterClassDefaultInfo ClassDefaultInfo = CharacterClassInfo->GetClassDefaultInfo(CharacterClass);
 
 	ApplyAttributes(ASC, AvatarActor, ClassDefaultInfo.PrimaryAttributes, Level);
 	ApplyAttributes(ASC, AvatarActor, CharacterClassInfo->SecondaryAttributes, Level);
 	ApplyAttributes(ASC, AvatarActor, CharacterClassInfo->VitalAttributes, Level);
+
+	if (bCaptureSnapshot)
+	{
+		SnapshotSubsystem->CaptureSnapshot(ASC, CharacterClass, Level, CharacterClassInfo->SecondaryAttributes);
+	}
 }
 
 void UAuraAbilitySystemLibrary::ApplyAttributes(UAbilitySystemComponent* ASC, AActor* AvatarActor, TSubclassOf<UGameplayEffect> EffectClass, float Level)
@@ -128,7 +143,7 @@ int32 UAuraAbilitySystemLibrary::GetXPRewardForClassAndLevel(const UObject* Worl
 	if(CharacterClassInfo == nullptr) return 0;
 
 	const FCharacterClassDefaultInfo& Info = CharacterClassInfo->GetClassDefaultInfo(CharacterClass);
-	const float XPReward = Info.XPReward.GetValueAtLevel(CharacterLevel);
+	const float XPReward = FAuraCompiledCurves::Get().EvalScalableFloat(Info.XPReward, CharacterLevel);
 
 	return static_cast<int32>(XPReward);
 }
@@ -296,6 +311,24 @@ void UAuraAbilitySystemLibrary::SetDeathImpulse(UPARAM(ref) FGameplayEffectConte
 	}
 }
 
+uint64 UAuraAbilitySystemLibrary::GetRollSeed(const FGameplayEffectContextHandle& EffectContextHandle)
+{
+	if (const FAuraGameplayEffectContext* AuraEffectContext = static_cast<const FAuraGameplayEffectContext*>(EffectContextHandle.Get()))
+	{
+		return AuraEffectContext->GetRollSeed();
+	}
+
+	return 0;
+}
+
+void UAuraAbilitySystemLibrary::SetRollSeed(FGameplayEffectContextHandle& EffectContextHandle, uint64 InRollSeed)
+{
+	if (FAuraGameplayEffectContext* AuraEffectContext = static_cast<FAuraGameplayEffectContext*>(EffectContextHandle.Get()))
+	{
+		AuraEffectContext->SetRollSeed(InRollSeed);
+	}
+}
+
 void UAuraAbilitySystemLibrary::GetLivePlayersWithinRadius(const UObject *WorldContextObject,
                                                            TArray<AActor *> &OutOverlappingActors, const TArray<AActor *> &ActorsToIgnore,
                                                            float Radius, const FVector &SphereOrigin)
@@ -334,6 +367,14 @@ FGameplayEffectContextHandle UAuraAbilitySystemLibrary::ApplyDamageEffect(const
 	FGameplayEffectContextHandle EffectContextHandle = DamageEffectParams.SourceAbilitySystemComponent->MakeEffectContext();
 	EffectContextHandle.AddSourceObject(SourceAvatarActor);
 	SetDeathImpulse(EffectContextHandle, DamageEffectParams.DeathImpulse);
+	if (DamageEffectParams.RollSeed != 0)
+	{
+		SetRollSeed(EffectContextHandle, DamageEffectParams.RollSeed);
+	}
+	else if (UAuraAbilitySystemComponent* SourceAuraASC = Cast<UAuraAbilitySystemComponent>(DamageEffectParams.SourceAbilitySystemComponent))
+	{
+		SetRollSeed(EffectContextHandle, SourceAuraASC->NextRollSeed());
+	}
 
 	const FGameplayEffectSpecHandle SpecHandle = DamageEffectParams.SourceAbilitySystemComponent->MakeOutgoingSpec(DamageEffectParams.DamageGameplayEffectClass, 
 		DamageEffectParams.AbilityLevel, EffectContextHandle);
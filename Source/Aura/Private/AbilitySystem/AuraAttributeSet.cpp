@@ -13,7 +13,24 @@
 #include "Kismet/GameplayStatics.h"
 #include "Player/AuraPlayerController.h"
 #include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystem/Debuff/AuraDoTSubsystem.h"
+#include "AbilitySystem/Regen/AuraRegenSubsystem.h"
+#include "AbilitySystem/XP/AuraXPLedgerSubsystem.h"
+#include "GameFramework/GameStateBase.h"
+#include "Aura/AuraStats.h"
+#include "Game/AuraCombatLogSubsystem.h"
+
+static TAutoConsoleVariable<bool> CVarAuraAnalyticRegen(
+	TEXT("Aura.Regen.Analytic"),
+	true,
+	TEXT("Evaluate Health/Mana regeneration from replicated (value, rate, time) anchors instead of periodic effects."));
+
+static TAutoConsoleVariable<bool> CVarAuraXPLedger(
+	TEXT("Aura.XP.Ledger"),
+	true,
+	TEXT("Deliver kill XP through the per frame XP ledger instead of a gameplay event per kill."));
 
 UAuraAttributeSet::UAuraAttributeSet()
 {
@@ -79,6 +96,8 @@ void UAuraAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 
 	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Health, COND_None, REPNOTIFY_Always);
 	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Mana, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, HealthRegenState, COND_None, REPNOTIFY_OnChanged);
+	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, ManaRegenState, COND_None, REPNOTIFY_OnChanged);
 
 	/**
 	* Resistance Attribute Notifiers
@@ -107,12 +126,63 @@ void UAuraAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute,
 
 }
 
+bool UAuraAttributeSet::PreGameplayEffectExecute(FGameplayEffectModCallbackData& Data)
+{
+	if (!Super::PreGameplayEffectExecute(Data)) return false;
+
+	if (!CVarAuraAnalyticRegen.GetValueOnGameThread()) return true;
+
+	// Regeneration is evaluated analytically, so the periodic regen effects are only kept for their granted tags
+	if (IsRegenEffectExecution(Data)) return false;
+
+	// Only the vital this execution modifies is brought up to date, the other keeps its anchor and is not re-replicated
+	const FGameplayAttribute& Attribute = Data.EvaluatedData.Attribute;
+	if (Attribute == GetHealthAttribute() || Attribute == GetIncomingDamageAttribute())
+	{
+		SettleVitalRegen(GetHealthAttribute());
+	}
+	else if (Attribute == GetManaAttribute())
+	{
+		SettleVitalRegen(GetManaAttribute());
+	}
+	return true;
+}
+
+bool UAuraAttributeSet::IsRegenEffectExecution(const FGameplayEffectModCallbackData& Data) const
+{
+	if (Data.EffectSpec.GetPeriod() <= 0.f || Data.EffectSpec.Def == nullptr) return false;
+	if (Data.EvaluatedData.Attribute != GetHealthAttribute() && Data.EvaluatedData.Attribute != GetManaAttribute()) return false;
+
+	TArray<FGameplayEffectAttributeCaptureDefinition> CaptureDefinitions;
+	for (const FGameplayModifierInfo& ModifierInfo : Data.EffectSpec.Def->Modifiers)
+	{
+		if (ModifierInfo.Attribute != Data.EvaluatedData.Attribute) continue;
+
+		CaptureDefinitions.Reset();
+		ModifierInfo.ModifierMagnitude.GetAttributeCaptureDefinitions(CaptureDefinitions);
+		for (const FGameplayEffectAttributeCaptureDefinition& CaptureDefinition : CaptureDefinitions)
+		{
+			if (CaptureDefinition.AttributeToCapture == GetHealthRegenerationAttribute() || CaptureDefinition.AttributeToCapture == GetManaRegenerationAttribute())
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 void UAuraAttributeSet::GetEffectProperties(const FGameplayEffectModCallbackData& Data, FEffectProperties& Props) const
 {
 	// Source = causer of the effect, Target = target of the effect (owner of AS)
 
 	Props.EffectContextHandle = Data.EffectSpec.GetContext();
-	Props.SourceASC = Props.EffectContextHandle.GetInstigatorAbilitySystemComponent();
+	SetSourceProperties(Props.EffectContextHandle.GetInstigatorAbilitySystemComponent(), Props);
+	SetTargetProperties(&Data.Target, Props);
+}
+
+void UAuraAttributeSet::SetSourceProperties(UAbilitySystemComponent* SourceASC, FEffectProperties& Props) const
+{
+	Props.SourceASC = SourceASC;
 
 	if (IsValid(Props.SourceASC) && Props.SourceASC->AbilityActorInfo.IsValid() && Props.SourceASC->AbilityActorInfo->AvatarActor.IsValid())
 	{
@@ -133,18 +203,22 @@ void UAuraAttributeSet::GetEffectProperties(const FGameplayEffectModCallbackData
 		}
 
 	}
+}
 
-	if (Data.Target.AbilityActorInfo.IsValid() && Data.Target.AbilityActorInfo->AvatarActor.IsValid())
+void UAuraAttributeSet::SetTargetProperties(UAbilitySystemComponent* TargetASC, FEffectProperties& Props) const
+{
+	if (TargetASC->AbilityActorInfo.IsValid() && TargetASC->AbilityActorInfo->AvatarActor.IsValid())
 	{
-		Props.TargetAvatarActor = Data.Target.AbilityActorInfo->AvatarActor.Get();
-		Props.TargetController = Data.Target.AbilityActorInfo->PlayerController.Get();
+		Props.TargetAvatarActor = TargetASC->AbilityActorInfo->AvatarActor.Get();
+		Props.TargetController = TargetASC->AbilityActorInfo->PlayerController.Get();
 		Props.TargetCharacter = Cast<ACharacter>(Props.TargetAvatarActor);
-		Props.TargetASC = &Data.Target;
+		Props.TargetASC = TargetASC;
 	}
 }
 
 void UAuraAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraPostGameplayEffectExecute);
 	Super::PostGameplayEffectExecute(Data);
 
 	FEffectProperties Props;
@@ -187,21 +261,23 @@ void UAuraAttributeSet::HandleIncomingDamage(const FEffectProperties& Props)
 
 		if (bFatal)
 		{
-			//TODO: Use Death Impulse!
+			if (UAuraCombatLogSubsystem* CombatLog = GetWorld()->GetSubsystem<UAuraCombatLogSubsystem>())
+			{
+				CombatLog->RecordDeath(Props.SourceASC, Props.TargetASC);
+			}
 
 			ICombatInterface* CombatInterface = Cast<ICombatInterface>(Props.TargetAvatarActor);
 
 			if (CombatInterface)
 			{
-				CombatInterface->Die();
+				CombatInterface->Die(UAuraAbilitySystemLibrary::GetDeathImpulse(Props.EffectContextHandle));
 			}
 			SendXPEvent(Props);
+			SettleRegen();
 		}
-		else
+		else if (UAuraAbilitySystemComponent* AuraASC = Cast<UAuraAbilitySystemComponent>(Props.TargetASC))
 		{
-			FGameplayTagContainer TagContainer;
-			TagContainer.AddTag(FAuraGameplayTags::Get().Effects_HitReact);
-			Props.TargetASC->TryActivateAbilitiesByTag(TagContainer);
+			AuraASC->TryActivateHitReact();
 		}
 
 		const bool bBlock = UAuraAbilitySystemLibrary::IsBlockedHit(Props.EffectContextHandle);
@@ -216,42 +292,103 @@ void UAuraAttributeSet::HandleIncomingDamage(const FEffectProperties& Props)
 	}
 }
 
+void UAuraAttributeSet::HandlePeriodicDamage(UAbilitySystemComponent* SourceASC, float Damage)
+{
+	if (Damage <= 0.f) return;
+
+	FEffectProperties Props;
+	SetSourceProperties(SourceASC, Props);
+	SetTargetProperties(GetOwningAbilitySystemComponent(), Props);
+
+	if (Props.TargetCharacter == nullptr) return;
+	if (Props.TargetCharacter->Implements<UCombatInterface>() && ICombatInterface::Execute_IsDead(Props.TargetCharacter)) return;
+
+	// DoT ticks skip hit react and never roll for a new debuff
+	SettleVitalRegen(GetHealthAttribute());
+	const float NewHealth = GetHealth() - Damage;
+	SetHealth(FMath::Clamp(NewHealth, 0.f, GetMaxHealth()));
+
+	if (NewHealth <= 0.f)
+	{
+		if (UAuraCombatLogSubsystem* CombatLog = GetWorld()->GetSubsystem<UAuraCombatLogSubsystem>())
+		{
+			CombatLog->RecordDeath(Props.SourceASC, Props.TargetASC);
+		}
+		if (ICombatInterface* CombatInterface = Cast<ICombatInterface>(Props.TargetAvatarActor))
+		{
+			CombatInterface->Die(FVector::ZeroVector);
+		}
+		if (Props.SourceCharacter)
+		{
+			SendXPEvent(Props);
+		}
+		SettleRegen();
+	}
+
+	if (Props.SourceCharacter)
+	{
+		ShowFloatingText(Props, Damage, false, false);
+	}
+}
+
 void UAuraAttributeSet::HandleIncomingXP(const FEffectProperties& Props)
 {
-const float LocalIncomingXP = GetIncomingXP();
+	const float LocalIncomingXP = GetIncomingXP();
 	SetIncomingXP(0.f);
 
 	// Source Character is the owner, since GA_ListenForEvent applied GE_EventBasedEffect, adding to IncomingXP
-	if (Props.SourceCharacter->Implements<UPlayerInterface>() && Props.SourceCharacter->Implements<UCombatInterface>())
+	GrantXP(Props.SourceCharacter, LocalIncomingXP);
+}
+
+void UAuraAttributeSet::GrantXP(AActor* Recipient, int32 XP)
+{
+	if (XP <= 0 || !IsValid(Recipient)) return;
+
+	if (Recipient->Implements<UPlayerInterface>() && Recipient->Implements<UCombatInterface>())
 	{
-		const int32 CurrentLevel = ICombatInterface::Execute_GetPlayerLevel(Props.SourceCharacter);
-		const int32 CurrentXP = IPlayerInterface::Execute_GetXP(Props.SourceCharacter);
+		const int32 CurrentLevel = ICombatInterface::Execute_GetPlayerLevel(Recipient);
+		const int32 CurrentXP = IPlayerInterface::Execute_GetXP(Recipient);
 
-		const int32 NewLevel = IPlayerInterface::Execute_FindLevelForXP(Props.SourceCharacter, CurrentXP + LocalIncomingXP);
+		const int32 NewLevel = IPlayerInterface::Execute_FindLevelForXP(Recipient, CurrentXP + XP);
 		const int32 NumLevelUps = NewLevel - CurrentLevel;
 
 		if (NumLevelUps > 0)
 		{
-			const int32 AttributePointsReward = IPlayerInterface::Execute_GetAttributePointsReward(Props.SourceCharacter, CurrentLevel);
-			const int32 SpellPointsReward = IPlayerInterface::Execute_GetSpellPointsReward(Props.SourceCharacter, CurrentLevel);
+			// Every level crossed in one grant pays out its own reward
+			int32 AttributePointsReward = 0;
+			int32 SpellPointsReward = 0;
+			for (int32 LevelReached = CurrentLevel; LevelReached < NewLevel; ++LevelReached)
+			{
+				AttributePointsReward += IPlayerInterface::Execute_GetAttributePointsReward(Recipient, LevelReached);
+				SpellPointsReward += IPlayerInterface::Execute_GetSpellPointsReward(Recipient, LevelReached);
+			}
 
-			IPlayerInterface::Execute_AddToPlayerLevel(Props.SourceCharacter, NumLevelUps);
-			IPlayerInterface::Execute_AddToAttributePoints(Props.SourceCharacter, AttributePointsReward);
-			IPlayerInterface::Execute_AddToSpellPoints(Props.SourceCharacter, SpellPointsReward);
+			IPlayerInterface::Execute_AddToPlayerLevel(Recipient, NumLevelUps);
+			IPlayerInterface::Execute_AddToAttributePoints(Recipient, AttributePointsReward);
+			IPlayerInterface::Execute_AddToSpellPoints(Recipient, SpellPointsReward);
 
 			bTopOffHealth = true;
 			bTopOffMana = true;
 
-			IPlayerInterface::Execute_LevelUp(Props.SourceCharacter);
+			IPlayerInterface::Execute_LevelUp(Recipient);
+		}
+
+		if (UAuraCombatLogSubsystem* CombatLog = GetWorld()->GetSubsystem<UAuraCombatLogSubsystem>())
+		{
+			CombatLog->RecordXPGrant(Recipient, XP);
+			if (NumLevelUps > 0) CombatLog->RecordLevelUp(Recipient, NewLevel);
 		}
 
 
-		IPlayerInterface::Execute_AddToXP(Props.SourceCharacter, LocalIncomingXP);
+		IPlayerInterface::Execute_AddToXP(Recipient, XP);
 	}
 }
 
 void UAuraAttributeSet::Debuff(const FEffectProperties& Props)
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraDebuffCreation);
+	INC_DWORD_STAT(STAT_AuraDebuffsApplied);
+
 	const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
 	FGameplayEffectContextHandle EffectContext = Props.SourceASC->MakeEffectContext();
 	EffectContext.AddSourceObject(Props.SourceAvatarActor);
@@ -261,6 +398,17 @@ void UAuraAttributeSet::Debuff(const FEffectProperties& Props)
 	const float DebuffDuration = UAuraAbilitySystemLibrary::GetDebuffDuration(Props.EffectContextHandle);
 	const float DebuffFrequency = UAuraAbilitySystemLibrary::GetDebuffFrequency(Props.EffectContextHandle);
 
+	if (UAuraCombatLogSubsystem* CombatLog = GetWorld()->GetSubsystem<UAuraCombatLogSubsystem>())
+	{
+		CombatLog->RecordDebuff(Props.SourceASC, Props.TargetASC, DamageType, DebuffDamage, DebuffDuration, DebuffFrequency);
+	}
+
+	if (UAuraDoTSubsystem* DoTSubsystem = GetWorld()->GetSubsystem<UAuraDoTSubsystem>())
+	{
+		DoTSubsystem->AddDoT(Props.SourceASC, Props.TargetASC, GameplayTags.DamageTypesToDebuffs[DamageType], DebuffDamage, DebuffFrequency, DebuffDuration);
+		return;
+	}
+
 	FString DebuffName = FString::Printf(TEXT("DynamicDebuff_%s"), *DamageType.ToString());
 
 	UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage(), FName(DebuffName));
@@ -307,6 +455,142 @@ void UAuraAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute,
 		SetMana(GetMaxMana());
 		bTopOffMana = false;
 	}
+
+	if (bSettlingRegen || !CVarAuraAnalyticRegen.GetValueOnGameThread() || !GetOwningActor()->HasAuthority()) return;
+
+	const double Now = GetRegenTime();
+
+	// Any direct change to a vital re-anchors its curve at the new value
+	if (Attribute == GetHealthAttribute())
+	{
+		HealthRegenState.AnchorValue = NewValue;
+		HealthRegenState.AnchorTime = Now;
+	}
+	else if (Attribute == GetManaAttribute())
+	{
+		ManaRegenState.AnchorValue = NewValue;
+		ManaRegenState.AnchorTime = Now;
+	}
+	else if (Attribute == GetHealthRegenerationAttribute() || Attribute == GetMaxHealthAttribute())
+	{
+		SettleVital(HealthRegenState, GetHealthAttribute(), GetMaxHealth(), GetRegenRate(GetHealthRegeneration()), Now);
+	}
+	else if (Attribute == GetManaRegenerationAttribute() || Attribute == GetMaxManaAttribute())
+	{
+		SettleVital(ManaRegenState, GetManaAttribute(), GetMaxMana(), GetRegenRate(GetManaRegeneration()), Now);
+	}
+}
+
+void UAuraAttributeSet::SettleRegen()
+{
+	SettleVitalRegen(GetHealthAttribute());
+	SettleVitalRegen(GetManaAttribute());
+}
+
+float UAuraAttributeSet::GetSettledHealth() const
+{
+	if (!CVarAuraAnalyticRegen.GetValueOnGameThread()) return GetHealth();
+	return EvaluateVital(HealthRegenState, GetHealth(), GetMaxHealth(), GetRegenTime());
+}
+
+float UAuraAttributeSet::GetSettledMana() const
+{
+	if (!CVarAuraAnalyticRegen.GetValueOnGameThread()) return GetMana();
+	return EvaluateVital(ManaRegenState, GetMana(), GetMaxMana(), GetRegenTime());
+}
+
+void UAuraAttributeSet::ExtrapolateRegen()
+{
+	if (!CVarAuraAnalyticRegen.GetValueOnGameThread()) return;
+
+	if (GetOwningActor()->HasAuthority())
+	{
+		SettleRegen();
+		return;
+	}
+
+	UAbilitySystemComponent* ASC = GetOwningAbilitySystemComponent();
+	const double Now = GetRegenTime();
+
+	// Local only, the next replicated correction overwrites these
+	const float LocalHealth = HealthRegenState.Evaluate(Now, GetMaxHealth());
+	if (HealthRegenState.Rate > 0.f && LocalHealth > GetHealth())
+	{
+		ASC->SetNumericAttributeBase(GetHealthAttribute(), LocalHealth);
+	}
+
+	const float LocalMana = ManaRegenState.Evaluate(Now, GetMaxMana());
+	if (ManaRegenState.Rate > 0.f && LocalMana > GetMana())
+	{
+		ASC->SetNumericAttributeBase(GetManaAttribute(), LocalMana);
+	}
+}
+
+void UAuraAttributeSet::SettleVitalRegen(const FGameplayAttribute& VitalAttribute)
+{
+	if (!CVarAuraAnalyticRegen.GetValueOnGameThread() || !GetOwningActor()->HasAuthority()) return;
+
+	if (VitalAttribute == GetHealthAttribute())
+	{
+		SettleVital(HealthRegenState, VitalAttribute, GetMaxHealth(), GetRegenRate(GetHealthRegeneration()), GetRegenTime());
+	}
+	else if (VitalAttribute == GetManaAttribute())
+	{
+		SettleVital(ManaRegenState, VitalAttribute, GetMaxMana(), GetRegenRate(GetManaRegeneration()), GetRegenTime());
+	}
+}
+
+void UAuraAttributeSet::SettleVital(FAuraVitalRegen& RegenState, const FGameplayAttribute& VitalAttribute, float MaxValue, float NewRate, double Now)
+{
+	const float CurrentValue = VitalAttribute.GetNumericValue(this);
+	const float SettledValue = EvaluateVital(RegenState, CurrentValue, MaxValue, Now);
+
+	if (SettledValue != CurrentValue)
+	{
+		// The value moves along the existing curve, so PostAttributeChange must not re-anchor it
+		TGuardValue<bool> SettlingGuard(bSettlingRegen, true);
+		GetOwningAbilitySystemComponent()->SetNumericAttributeBase(VitalAttribute, SettledValue);
+	}
+
+	// Re-anchoring replicates the regen state, so only do it when the curve itself changes: a new rate, or a value clamped off it
+	const float FinalValue = VitalAttribute.GetNumericValue(this);
+	if (NewRate != RegenState.Rate || FinalValue != SettledValue)
+	{
+		RegenState.AnchorValue = FinalValue;
+		RegenState.AnchorTime = Now;
+		RegenState.Rate = NewRate;
+	}
+
+	if (NewRate > 0.f)
+	{
+		if (UAuraRegenSubsystem* RegenSubsystem = GetWorld()->GetSubsystem<UAuraRegenSubsystem>())
+		{
+			RegenSubsystem->Register(this);
+		}
+	}
+}
+
+float UAuraAttributeSet::EvaluateVital(const FAuraVitalRegen& RegenState, float CurrentValue, float MaxValue, double Now)
+{
+	return RegenState.Rate > 0.f ? FMath::Max(RegenState.Evaluate(Now, MaxValue), CurrentValue) : CurrentValue;
+}
+
+double UAuraAttributeSet::GetRegenTime() const
+{
+	const UWorld* World = GetWorld();
+	if (const AGameStateBase* GameState = World->GetGameState())
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+	return World->GetTimeSeconds();
+}
+
+float UAuraAttributeSet::GetRegenRate(float RegenAttributeValue) const
+{
+	const AActor* AvatarActor = GetOwningAbilitySystemComponent()->GetAvatarActor();
+	if (IsValid(AvatarActor) && AvatarActor->Implements<UCombatInterface>() && ICombatInterface::Execute_IsDead(AvatarActor)) return 0.f;
+
+	return FMath::Max(RegenAttributeValue, 0.f);
 }
 
 void UAuraAttributeSet::ShowFloatingText(const FEffectProperties& Props, float Damage, bool bBlockedHit, bool bCriticalHit) const
@@ -333,6 +617,15 @@ void UAuraAttributeSet::SendXPEvent(const FEffectProperties& Props)
 		const ECharacterClass TargetClass = ICombatInterface::Execute_GetCharacterClass(Props.TargetCharacter);
 		const int32 XPReward = UAuraAbilitySystemLibrary::GetXPRewardForClassAndLevel(Props.TargetCharacter, TargetClass, TargetLevel);
 
+		if (CVarAuraXPLedger.GetValueOnGameThread())
+		{
+			if (UAuraXPLedgerSubsystem* XPLedger = GetWorld()->GetSubsystem<UAuraXPLedgerSubsystem>())
+			{
+				XPLedger->AddKillXP(Props.SourceCharacter, Props.TargetCharacter, XPReward);
+				return;
+			}
+		}
+
 		const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
 		FGameplayEventData Payload;
 		Payload.EventTag = GameplayTags.Attributes_Meta_IncomingXP;
@@ -366,6 +659,22 @@ void UAuraAttributeSet::OnRep_MaxMana(const FGameplayAttributeData& OldMaxMana)
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, MaxMana, OldMaxMana);
 }
 
+void UAuraAttributeSet::OnRep_HealthRegenState()
+{
+	if (UAuraRegenSubsystem* RegenSubsystem = GetWorld()->GetSubsystem<UAuraRegenSubsystem>())
+	{
+		RegenSubsystem->Register(this);
+	}
+}
+
+void UAuraAttributeSet::OnRep_ManaRegenState()
+{
+	if (UAuraRegenSubsystem* RegenSubsystem = GetWorld()->GetSubsystem<UAuraRegenSubsystem>())
+	{
+		RegenSubsystem->Register(this);
+	}
+}
+
 /*
 * Primary Attribute Notify Functions
 */
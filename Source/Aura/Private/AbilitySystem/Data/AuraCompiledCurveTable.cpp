@@ -0,0 +1,349 @@
+// Copyright Adam Thomas
+
+
+#include "AbilitySystem/Data/AuraCompiledCurveTable.h"
+#include "Engine/CurveTable.h"
+#include "ScalableFloat.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Aura/AuraLogChannels.h"
+
+static TAutoConsoleVariable<bool> CVarAuraCompiledCurves(
+	TEXT("Aura.CompiledCurves"),
+	true,
+	TEXT("Evaluate damage, coefficient and XP curves from the compiled curve tables when they exist."));
+
+FAuraCompiledCurveTable::FAuraCompiledCurveTable() = default;
+FAuraCompiledCurveTable::~FAuraCompiledCurveTable() = default;
+
+bool FAuraCompiledCurveTable::Compile(const UCurveTable& Table, const UCurveTable& SourceAsset, int32 MaxLevel, TArray<uint8>& OutBytes, TArray<FString>& OutErrors)
+{
+	const int32 NumErrors = OutErrors.Num();
+	const TMap<FName, FRealCurve*>& RowMap = Table.GetRowMap();
+
+	if (RowMap.Num() == 0)
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s: table has no rows"), *Table.GetName()));
+		return false;
+	}
+
+	float HighestKeyTime = 0.f;
+	for (const TPair<FName, FRealCurve*>& Row : RowMap)
+	{
+		if (Row.Key.IsNone())
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s: row with no name"), *Table.GetName()));
+		}
+		if (Row.Value == nullptr || Row.Value->GetNumKeys() == 0)
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s: row %s has no keys"), *Table.GetName(), *Row.Key.ToString()));
+			continue;
+		}
+
+		float PreviousTime = -UE_BIG_NUMBER;
+		for (auto It = Row.Value->GetKeyHandleIterator(); It; ++It)
+		{
+			const TPair<float, float> Key = Row.Value->GetKeyTimeValuePair(*It);
+			if (!FMath::IsFinite(Key.Key) || !FMath::IsFinite(Key.Value))
+			{
+				OutErrors.Add(FString::Printf(TEXT("%s: row %s has a non-finite key"), *Table.GetName(), *Row.Key.ToString()));
+			}
+			else if (Key.Key < 0.f || Key.Key <= PreviousTime)
+			{
+				OutErrors.Add(FString::Printf(TEXT("%s: row %s key at level %f is negative or out of order"), *Table.GetName(), *Row.Key.ToString(), Key.Key));
+			}
+			PreviousTime = Key.Key;
+			HighestKeyTime = FMath::Max(HighestKeyTime, Key.Key);
+		}
+	}
+
+	if (MaxLevel <= 0)
+	{
+		MaxLevel = FMath::CeilToInt(HighestKeyTime);
+	}
+	else if (HighestKeyTime > MaxLevel)
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s: keys go up to level %f, past MaxLevel %d"), *Table.GetName(), HighestKeyTime, MaxLevel));
+	}
+
+	if (OutErrors.Num() > NumErrors) return false;
+
+	const int32 NumLevels = MaxLevel + 1;
+
+	// A text source only stands in for its asset if every row gives the same value at every whole level
+	const TMap<FName, FRealCurve*>& AssetRowMap = SourceAsset.GetRowMap();
+	if (AssetRowMap.Num() != RowMap.Num())
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s: %d rows, its asset %s has %d"), *Table.GetName(), RowMap.Num(), *SourceAsset.GetPathName(), AssetRowMap.Num()));
+	}
+	for (const TPair<FName, FRealCurve*>& Row : RowMap)
+	{
+		const FRealCurve* AssetCurve = AssetRowMap.FindRef(Row.Key);
+		if (AssetCurve == nullptr)
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s: row %s is not in its asset %s"), *Table.GetName(), *Row.Key.ToString(), *SourceAsset.GetPathName()));
+			continue;
+		}
+		for (int32 Level = 0; Level < NumLevels; ++Level)
+		{
+			const float Value = Row.Value->Eval(static_cast<float>(Level));
+			const float AssetValue = AssetCurve->Eval(static_cast<float>(Level));
+			if (!FMath::IsNearlyEqual(Value, AssetValue, FMath::Max(1.e-3f, FMath::Abs(AssetValue) * 1.e-4f)))
+			{
+				OutErrors.Add(FString::Printf(TEXT("%s: row %s is %f at level %d, its asset has %f"), *Table.GetName(), *Row.Key.ToString(), Value, Level, AssetValue));
+				break;
+			}
+		}
+	}
+
+	if (OutErrors.Num() > NumErrors) return false;
+
+	// Sorted so the same rows compile to the same bytes whichever source they came from
+	TArray<TPair<FName, FRealCurve*>> Rows = RowMap.Array();
+	Rows.Sort([](const TPair<FName, FRealCurve*>& A, const TPair<FName, FRealCurve*>& B) { return A.Key.LexicalLess(B.Key); });
+
+	TArray<uint8> Names;
+	TArray<float> Values;
+	Values.Reserve(Rows.Num() * NumLevels);
+	for (const TPair<FName, FRealCurve*>& Row : Rows)
+	{
+		const FTCHARToUTF8 Name(*Row.Key.ToString());
+		const uint16 NameLength = static_cast<uint16>(Name.Length());
+		Names.Append(reinterpret_cast<const uint8*>(&NameLength), sizeof(NameLength));
+		Names.Append(reinterpret_cast<const uint8*>(Name.Get()), NameLength);
+		Names.Add(IsConstantCurve(*AssetRowMap.FindChecked(Row.Key)) ? RowFlag_Constant : 0);
+
+		for (int32 Level = 0; Level < NumLevels; ++Level)
+		{
+			Values.Add(Row.Value->Eval(static_cast<float>(Level)));
+		}
+	}
+
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumRows = Rows.Num();
+	Header.NumLevels = NumLevels;
+	Header.NamesOffset = sizeof(FHeader);
+	Header.NamesSize = Names.Num();
+	Header.SamplesOffset = Align(Header.NamesOffset + Header.NamesSize, 16);
+	Header.SourceHash = HashSource(SourceAsset);
+
+	OutBytes.Reset();
+	OutBytes.SetNumZeroed(Header.SamplesOffset + Values.Num() * sizeof(float));
+	FMemory::Memcpy(OutBytes.GetData(), &Header, sizeof(FHeader));
+	FMemory::Memcpy(OutBytes.GetData() + Header.NamesOffset, Names.GetData(), Names.Num());
+	FMemory::Memcpy(OutBytes.GetData() + Header.SamplesOffset, Values.GetData(), Values.Num() * sizeof(float));
+	return true;
+}
+
+uint32 FAuraCompiledCurveTable::HashSource(const UCurveTable& Table)
+{
+	TArray<TPair<FName, FRealCurve*>> Rows = Table.GetRowMap().Array();
+	Rows.Sort([](const TPair<FName, FRealCurve*>& A, const TPair<FName, FRealCurve*>& B) { return A.Key.LexicalLess(B.Key); });
+
+	uint32 Hash = 0;
+	for (const TPair<FName, FRealCurve*>& Row : Rows)
+	{
+		const FString RowName = Row.Key.ToString();
+		Hash = FCrc::StrCrc32(*RowName, Hash);
+		if (Row.Value == nullptr) continue;
+
+		const FRichCurve* RichCurve = Table.GetCurveTableMode() == ECurveTableMode::RichCurves ? static_cast<const FRichCurve*>(Row.Value) : nullptr;
+		for (auto It = Row.Value->GetKeyHandleIterator(); It; ++It)
+		{
+			const TPair<float, float> Key = Row.Value->GetKeyTimeValuePair(*It);
+			const uint8 InterpMode = Row.Value->GetKeyInterpMode(*It);
+			Hash = FCrc::MemCrc32(&Key.Key, sizeof(float), Hash);
+			Hash = FCrc::MemCrc32(&Key.Value, sizeof(float), Hash);
+			Hash = FCrc::MemCrc32(&InterpMode, sizeof(uint8), Hash);
+			if (RichCurve)
+			{
+				const FRichCurveKey& RichKey = RichCurve->GetKey(*It);
+				Hash = FCrc::MemCrc32(&RichKey.ArriveTangent, sizeof(float), Hash);
+				Hash = FCrc::MemCrc32(&RichKey.LeaveTangent, sizeof(float), Hash);
+			}
+		}
+	}
+	return Hash;
+}
+
+bool FAuraCompiledCurveTable::IsConstantCurve(const FRealCurve& Curve)
+{
+	// The last key's mode never applies, every segment before it has to hold its value
+	const int32 NumKeys = Curve.GetNumKeys();
+	int32 KeyIndex = 0;
+	for (auto It = Curve.GetKeyHandleIterator(); It && KeyIndex < NumKeys - 1; ++It, ++KeyIndex)
+	{
+		if (Curve.GetKeyInterpMode(*It) != RCIM_Constant) return false;
+	}
+	return NumKeys > 1;
+}
+
+bool FAuraCompiledCurveTable::Load(const FString& Filename)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*Filename));
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+		if (MappedRegion.IsValid())
+		{
+			return Parse(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+		}
+	}
+
+	if (!FFileHelper::LoadFileToArray(LoadedBytes, *Filename, FILEREAD_Silent)) return false;
+	return Parse(LoadedBytes.GetData(), LoadedBytes.Num());
+}
+
+bool FAuraCompiledCurveTable::Parse(const uint8* Data, int64 Size)
+{
+	if (Size < static_cast<int64>(sizeof(FHeader))) return false;
+
+	FHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(FHeader));
+	if (Header.Magic != Magic || Header.Version != Version) return false;
+
+	const int64 SamplesSize = static_cast<int64>(Header.NumRows) * Header.NumLevels * sizeof(float);
+	if (static_cast<int64>(Header.NamesOffset) + Header.NamesSize > Size || Header.SamplesOffset + SamplesSize > Size) return false;
+
+	RowIndices.Reset();
+	RowIndices.Reserve(Header.NumRows);
+	ConstantRows.Init(false, Header.NumRows);
+	const uint8* Name = Data + Header.NamesOffset;
+	const uint8* NamesEnd = Name + Header.NamesSize;
+	for (uint32 Row = 0; Row < Header.NumRows; ++Row)
+	{
+		uint16 NameLength = 0;
+		if (Name + sizeof(NameLength) > NamesEnd) return false;
+		FMemory::Memcpy(&NameLength, Name, sizeof(NameLength));
+		Name += sizeof(NameLength);
+		if (Name + NameLength + 1 > NamesEnd) return false;
+
+		const FUTF8ToTCHAR RowName(reinterpret_cast<const ANSICHAR*>(Name), NameLength);
+		RowIndices.Add(FName(RowName.Length(), RowName.Get()), Row);
+		Name += NameLength;
+		ConstantRows[Row] = (*Name & RowFlag_Constant) != 0;
+		++Name;
+	}
+
+	Samples = reinterpret_cast<const float*>(Data + Header.SamplesOffset);
+	NumRows = Header.NumRows;
+	NumLevels = Header.NumLevels;
+	SourceHash = Header.SourceHash;
+	return true;
+}
+
+int32 FAuraCompiledCurveTable::FindRow(FName RowName) const
+{
+	const int32* RowIndex = RowIndices.Find(RowName);
+	return RowIndex ? *RowIndex : INDEX_NONE;
+}
+
+float FAuraCompiledCurveTable::Eval(int32 RowIndex, float Level) const
+{
+	check(RowIndex >= 0 && RowIndex < NumRows);
+	const float* Row = Samples + RowIndex * NumLevels;
+
+	// Matches the constant extrapolation of the source curves
+	const float ClampedLevel = FMath::Clamp(Level, 0.f, static_cast<float>(NumLevels - 1));
+	const int32 LowerLevel = FMath::FloorToInt(ClampedLevel);
+	if (ConstantRows[RowIndex]) return Row[LowerLevel];
+
+	const int32 UpperLevel = FMath::Min(LowerLevel + 1, NumLevels - 1);
+	return FMath::Lerp(Row[LowerLevel], Row[UpperLevel], ClampedLevel - LowerLevel);
+}
+
+bool FAuraCompiledCurveTable::Eval(FName RowName, float Level, float& OutValue) const
+{
+	const int32 RowIndex = FindRow(RowName);
+	if (RowIndex == INDEX_NONE) return false;
+
+	OutValue = Eval(RowIndex, Level);
+	return true;
+}
+
+FAuraCompiledCurves& FAuraCompiledCurves::Get()
+{
+	static FAuraCompiledCurves CompiledCurves;
+	return CompiledCurves;
+}
+
+bool FAuraCompiledCurves::IsEnabled()
+{
+	return CVarAuraCompiledCurves.GetValueOnAnyThread();
+}
+
+FString FAuraCompiledCurves::GetCompiledDirectory()
+{
+	return FPaths::ProjectContentDir() / TEXT("CompiledCurves");
+}
+
+FString FAuraCompiledCurves::GetCompiledFilename(const FString& PackageName)
+{
+	FString RelativePath = PackageName;
+	RelativePath.RemoveFromStart(TEXT("/"));
+	return GetCompiledDirectory() / RelativePath + TEXT(".auracurve");
+}
+
+const FAuraCompiledCurveTable* FAuraCompiledCurves::FindTable(const UCurveTable& Table)
+{
+	const FObjectKey TableKey(&Table);
+	if (const TUniquePtr<FAuraCompiledCurveTable>* Existing = Tables.Find(TableKey))
+	{
+		return Existing->Get();
+	}
+
+	TUniquePtr<FAuraCompiledCurveTable> Compiled = MakeUnique<FAuraCompiledCurveTable>();
+	const FString Filename = GetCompiledFilename(Table.GetPackage()->GetName());
+	if (!FPaths::FileExists(Filename) || !Compiled->Load(Filename))
+	{
+		Compiled.Reset();
+	}
+#if WITH_EDITOR
+	// Assets only change under the editor, cooked builds skip walking every key
+	else if (Compiled->GetSourceHash() != FAuraCompiledCurveTable::HashSource(Table))
+	{
+		UE_LOG(LogAura, Warning, TEXT("Compiled curve table %s is out of date with %s, using the asset. Run -run=AuraCompileCurves to rebuild it"), *Filename, *Table.GetPathName());
+		Compiled.Reset();
+	}
+#endif
+	else
+	{
+		UE_LOG(LogAura, Log, TEXT("Loaded compiled curve table %s, %d rows, %d levels"), *Table.GetPathName(), Compiled->GetNumRows(), Compiled->GetNumLevels());
+	}
+	return Tables.Add(TableKey, MoveTemp(Compiled)).Get();
+}
+
+float FAuraCompiledCurves::EvalCurve(const UCurveTable* Table, FName RowName, float Level)
+{
+	if (Table == nullptr) return 0.f;
+
+	float Value = 0.f;
+	if (IsEnabled())
+	{
+		const FAuraCompiledCurveTable* Compiled = FindTable(*Table);
+		if (Compiled && Compiled->Eval(RowName, Level, Value)) return Value;
+	}
+
+	const FRealCurve* Curve = Table->FindCurve(RowName, FString());
+	return Curve ? Curve->Eval(Level) : 0.f;
+}
+
+float FAuraCompiledCurves::EvalScalableFloat(const FScalableFloat& ScalableFloat, float Level)
+{
+	if (IsEnabled() && ScalableFloat.Curve.CurveTable)
+	{
+		float Value = 0.f;
+		const FAuraCompiledCurveTable* Compiled = FindTable(*ScalableFloat.Curve.CurveTable);
+		if (Compiled && Compiled->Eval(ScalableFloat.Curve.RowName, Level, Value))
+		{
+			return ScalableFloat.Value * Value;
+		}
+	}
+	return ScalableFloat.GetValueAtLevel(Level);
+}
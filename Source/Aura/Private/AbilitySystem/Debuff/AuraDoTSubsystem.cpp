@@ -0,0 +1,168 @@
+// Copyright Adam Thomas
+
+
+#include "AbilitySystem/Debuff/AuraDoTSubsystem.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Interaction/CombatInterface.h"
+#include "Aura/AuraLogChannels.h"
+
+// Shorter periods are clamped so a bad frequency cannot spin the per-frame tick loop
+static constexpr float MinDoTPeriod = 0.05f;
+
+void UAuraDoTSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (TargetASCs.Num() == 0) return;
+
+	PendingDamage.Reset();
+
+	// Advance every DoT in one pass, summing the damage each target takes this frame
+	for (int32 Index = TargetASCs.Num() - 1; Index >= 0; --Index)
+	{
+		if (!TargetASCs[Index].IsValid())
+		{
+			RemoveDoTAt(Index);
+			continue;
+		}
+
+		float NextTick = TimeUntilNextTick[Index];
+		const float TickLimit = FMath::Min(DeltaTime, TimeRemaining[Index]);
+		int32 NumTicks = 0;
+
+		while (NextTick <= TickLimit)
+		{
+			++NumTicks;
+			NextTick += Periods[Index];
+		}
+
+		TimeUntilNextTick[Index] = NextTick - DeltaTime;
+		TimeRemaining[Index] -= DeltaTime;
+
+		if (NumTicks > 0)
+		{
+			PendingDamage.FindOrAdd(FDoTKey(TargetASCs[Index], SourceASCs[Index])) += DamagePerTick[Index] * NumTicks;
+		}
+
+		if (TimeRemaining[Index] <= 0.f)
+		{
+			RemoveDoTAt(Index);
+		}
+	}
+
+	// Apply the aggregated damage once per source on each target, so damage numbers and kill XP go to whoever dealt it
+	for (const TPair<FDoTKey, float>& Pair : PendingDamage)
+	{
+		if (UAbilitySystemComponent* TargetASC = Pair.Key.Key.Get())
+		{
+			ApplyDamage(Pair.Key.Value.Get(), TargetASC, Pair.Value);
+		}
+	}
+}
+
+TStatId UAuraDoTSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraDoTSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraDoTSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraDoTSubsystem::AddDoT(UAbilitySystemComponent* SourceASC, UAbilitySystemComponent* TargetASC, const FGameplayTag& DebuffTag, float InDamagePerTick, float Frequency, float Duration)
+{
+	if (!IsValid(TargetASC) || !DebuffTag.IsValid() || Duration <= 0.f) return;
+
+	if (Frequency <= 0.f)
+	{
+		UE_LOG(LogAura, Warning, TEXT("Ignoring %s DoT with a frequency of %f"), *DebuffTag.ToString(), Frequency);
+		return;
+	}
+
+	const float Period = FMath::Max(Frequency, MinDoTPeriod);
+
+	for (int32 Index = 0; Index < TargetASCs.Num(); ++Index)
+	{
+		if (TargetASCs[Index] == TargetASC && SourceASCs[Index] == SourceASC && DebuffTags[Index] == DebuffTag)
+		{
+			DamagePerTick[Index] = InDamagePerTick;
+			Periods[Index] = Period;
+			TimeRemaining[Index] = Duration;
+			return;
+		}
+	}
+
+	SourceASCs.Add(SourceASC);
+	TargetASCs.Add(TargetASC);
+	DebuffTags.Add(DebuffTag);
+	DamagePerTick.Add(InDamagePerTick);
+	Periods.Add(Period);
+	TimeUntilNextTick.Add(Period);
+	TimeRemaining.Add(Duration);
+
+	// Debuff tags are still granted so debuff visuals and other tag listeners keep working
+	TargetASC->AddLooseGameplayTag(DebuffTag);
+	TargetASC->AddMinimalReplicationGameplayTag(DebuffTag);
+
+	// Matches the periodic effect default of executing on application
+	ApplyDamage(SourceASC, TargetASC, InDamagePerTick);
+}
+
+void UAuraDoTSubsystem::ApplyDamage(UAbilitySystemComponent* SourceASC, UAbilitySystemComponent* TargetASC, float Damage)
+{
+	AActor* TargetAvatar = TargetASC->GetAvatarActor();
+	const bool bCanDie = IsValid(TargetAvatar) && TargetAvatar->Implements<UCombatInterface>();
+	if (bCanDie && ICombatInterface::Execute_IsDead(TargetAvatar)) return;
+
+	if (UAuraAttributeSet* AuraAS = GetAuraAttributeSet(TargetASC))
+	{
+		AuraAS->HandlePeriodicDamage(SourceASC, Damage);
+	}
+
+	if (bCanDie && ICombatInterface::Execute_IsDead(TargetAvatar))
+	{
+		RemoveDoTsOnTarget(TargetASC);
+	}
+}
+
+void UAuraDoTSubsystem::RemoveDoTsOnTarget(const UAbilitySystemComponent* TargetASC)
+{
+	for (int32 Index = TargetASCs.Num() - 1; Index >= 0; --Index)
+	{
+		if (TargetASCs[Index] == TargetASC)
+		{
+			RemoveDoTAt(Index);
+		}
+	}
+}
+
+void UAuraDoTSubsystem::RemoveDoTAt(int32 Index)
+{
+	if (UAbilitySystemComponent* TargetASC = TargetASCs[Index].Get())
+	{
+		TargetASC->RemoveLooseGameplayTag(DebuffTags[Index]);
+		TargetASC->RemoveMinimalReplicationGameplayTag(DebuffTags[Index]);
+	}
+
+	SourceASCs.RemoveAtSwap(Index, 1, false);
+	TargetASCs.RemoveAtSwap(Index, 1, false);
+	DebuffTags.RemoveAtSwap(Index, 1, false);
+	DamagePerTick.RemoveAtSwap(Index, 1, false);
+	Periods.RemoveAtSwap(Index, 1, false);
+	TimeUntilNextTick.RemoveAtSwap(Index, 1, false);
+	TimeRemaining.RemoveAtSwap(Index, 1, false);
+}
+
+UAuraAttributeSet* UAuraDoTSubsystem::GetAuraAttributeSet(const UAbilitySystemComponent* ASC)
+{
+	for (UAttributeSet* AttributeSet : ASC->GetSpawnedAttributes())
+	{
+		if (UAuraAttributeSet* AuraAS = Cast<UAuraAttributeSet>(AttributeSet))
+		{
+			return AuraAS;
+		}
+	}
+	return nullptr;
+}
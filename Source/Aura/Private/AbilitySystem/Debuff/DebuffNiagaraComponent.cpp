@@ -5,6 +5,7 @@
 #include "Interaction/CombatInterface.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
+#include "Aura/Aura.h"
 
 UDebuffNiagaraComponent::UDebuffNiagaraComponent()
 {
@@ -15,6 +16,9 @@ void UDebuffNiagaraComponent::BeginPlay()
 {
     Super::BeginPlay();
 
+    if (!DebuffTag.IsValid()) return;
+
+#if WITH_AURA_COSMETICS
     ICombatInterface* CombatInterface = Cast<ICombatInterface>(GetOwner());
 
     if (UAbilitySystemComponent* ASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetOwner()))
@@ -28,6 +32,7 @@ void UDebuffNiagaraComponent::BeginPlay()
             InASC->RegisterGameplayTagEvent(DebuffTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &UDebuffNiagaraComponent::DebuffTagChanged);
         });
     }
+#endif
 }
 
 void UDebuffNiagaraComponent::DebuffTagChanged(const FGameplayTag CallbackTag, int32 NewCount)
@@ -3,12 +3,18 @@
 
 #include "AbilitySystem/ExecCalc/ExecCalc_Damage.h"
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "AbilitySystem/AuraAttributeSet.h"
 #include "AuraGameplayTags.h"
 #include "AbilitySystem/Data/CharacterClassInfo.h"
 #include "AbilitySystem/AuraAbilitySystemLibrary.h"
 #include "Interaction/CombatInterface.h"
 #include "AuraAbilityTypes.h"
+#include "AbilitySystem/Data/AuraCompiledCurveTable.h"
+#include "AbilitySystem/AuraRandomStream.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "Aura/AuraStats.h"
+#include "Game/AuraCombatLogSubsystem.h"
 
 struct AuraDamageStatics
 {
@@ -61,7 +67,7 @@ UExecCalc_Damage::UExecCalc_Damage()
 	RelevantAttributesToCapture.Add(DamageStatics().PhysicalResistanceDef);
 }
 
-void UExecCalc_Damage::DetermineDebuff(const FGameplayEffectCustomExecutionParameters& ExecutionParams, const FGameplayEffectSpec& Spec, FAggregatorEvaluateParameters EvaluationParams, const TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition>& InTagsToDefs) const
+void UExecCalc_Damage::DetermineDebuff(const FGameplayEffectCustomExecutionParameters& ExecutionParams, const FGameplayEffectSpec& Spec, FAggregatorEvaluateParameters EvaluationParams, const TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition>& InTagsToDefs, FAuraRandomStream& RollStream) const
 {
 		const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
 
@@ -81,7 +87,7 @@ void UExecCalc_Damage::DetermineDebuff(const FGameplayEffectCustomExecutionParam
 			TargetDebuffResistance = FMath::Max<float>(TargetDebuffResistance, 0.f);
 
 			const float EffectiveDebuffChance = SourceDebuffChance * ( 100 - TargetDebuffResistance ) / 100;
-			const bool bDebuff = FMath::RandRange(1, 100) < EffectiveDebuffChance;
+			const bool bDebuff = RollStream.RandRange(1, 100) < EffectiveDebuffChance;
 			if (bDebuff)
 			{
 				FGameplayEffectContextHandle ContextHandle = Spec.GetContext();
@@ -105,6 +111,9 @@ void UExecCalc_Damage::DetermineDebuff(const FGameplayEffectCustomExecutionParam
 void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, 
 	FGameplayEffectCustomExecutionOutput& OutExecuteOutput) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraExecCalcDamage);
+	INC_DWORD_STAT(STAT_AuraDamageExecutions);
+
 	TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition> TagsToCaptureDefs;
 	const FAuraGameplayTags& Tags = FAuraGameplayTags::Get();
 
@@ -146,12 +155,30 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 	EvaluationParameters.SourceTags = SourceTags;
 	EvaluationParameters.TargetTags = TargetTags;
 
+	// Block then crit are the first two rolls of the context's seed, so the same seed reproduces the same outcome.
+	// Debuffs roll once per damage type on the spec, so they draw from their own stream and never shift block and crit
+	// Effects applied without ApplyDamageEffect have no seed yet and take the next one from the source, or the target for sourceless effects
+	uint64 RollSeed = UAuraAbilitySystemLibrary::GetRollSeed(Spec.GetContext());
+	if (RollSeed == 0)
+	{
+		UAuraAbilitySystemComponent* SeedASC = Cast<UAuraAbilitySystemComponent>(ExecutionParams.GetSourceAbilitySystemComponent());
+		if (SeedASC == nullptr)
+		{
+			SeedASC = Cast<UAuraAbilitySystemComponent>(ExecutionParams.GetTargetAbilitySystemComponent());
+		}
+		RollSeed = SeedASC ? SeedASC->NextRollSeed() : 1;
+	}
+	FAuraRandomStream RollStream(RollSeed);
+	FAuraRandomStream DebuffRollStream(FAuraRandomStream::MixSeed(RollSeed, 1));
+
 	// Debuff
 
-	DetermineDebuff(ExecutionParams, Spec, EvaluationParameters, TagsToCaptureDefs);
+	DetermineDebuff(ExecutionParams, Spec, EvaluationParameters, TagsToCaptureDefs, DebuffRollStream);
 
 	// Get Damage Set by Caller Magnitude
 	float Damage = 0.f;
+	FGameplayTag PrimaryDamageType;
+	float PrimaryDamageTypeValue = 0.f;
 	for (const TTuple<FGameplayTag, FGameplayTag>& Pair : FAuraGameplayTags::Get().DamageTypesToResistances)
 	{
 		const FGameplayTag DamageTypeTag = Pair.Key;
@@ -162,14 +189,15 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 		const FGameplayEffectAttributeCaptureDefinition CaptureDef = TagsToCaptureDefs[ResistanceTag];
 
 		float DamageTypeValue = Spec.GetSetByCallerMagnitude(Pair.Key, false);
+		if (DamageTypeValue > PrimaryDamageTypeValue)
+		{
+			PrimaryDamageType = DamageTypeTag;
+			PrimaryDamageTypeValue = DamageTypeValue;
+		}
 
 		float ResistanceValue = 0.f;
 		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(CaptureDef, EvaluationParameters, ResistanceValue);
-		ResistanceValue = FMath::Clamp(ResistanceValue, 0.f, 100.f);
-
-		DamageTypeValue *= (100.f - ResistanceValue) / 100.f;
-
-		Damage += DamageTypeValue;
+		Damage += FAuraDamageKernel::ApplyResistance(DamageTypeValue, ResistanceValue);
 	}
 
 	// Capture BlockChance on Target, and determine if there was a Block
@@ -187,14 +215,15 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 	// In a gameplay effect execution calculation, order of calculations matter
 	// So if Blocked and halves the incoming damage, this affects the rest of the subsequent calculations
 
-	const bool bBlocked = FMath::RandRange(1, 100) < TargetBlockChance;
+	const bool bBlocked = RollStream.RandRange(1, 100) < TargetBlockChance;
+	const float ResistedDamage = Damage;
 
 	FGameplayEffectContextHandle EffectContextHandle = Spec.GetEffectContext();
 
 	UAuraAbilitySystemLibrary::SetIsBlockedHit(EffectContextHandle, bBlocked);
 
 	// If bBlocked is true, damage is halved
-	Damage = bBlocked ? Damage / 2.f : Damage;
+	Damage = FAuraDamageKernel::ApplyBlock(Damage, bBlocked);
 
 	// Armour and Armour Penetration implementation
 	// Target Armour, Source Armour Penetration
@@ -208,18 +237,12 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 	SourceArmourPenetration = FMath::Max<float>(SourceArmourPenetration, 0.f);
 
 	const UCharacterClassInfo* CharacterClassInfo = UAuraAbilitySystemLibrary::GetCharacterClassInfo(SourceAvatar);
-	const FRealCurve* ArmourPenetrationCurve = CharacterClassInfo->DamageCalculationCoefficients->FindCurve(FName("ArmourPenetration"), FString());
-	const float ArmourPenetrationCoefficient = ArmourPenetrationCurve->Eval(SourcePlayerLevel);
+	const float ArmourPenetrationCoefficient = FAuraCompiledCurves::Get().EvalCurve(CharacterClassInfo->DamageCalculationCoefficients, FName("ArmourPenetration"), SourcePlayerLevel);
 
-	// EffectiveArmour will store the percentage of the Target's Armour
-	// Armour Penetration ignores a percentage of the Target's Armour
-	const float EffectiveArmour = TargetArmour * (100 - SourceArmourPenetration * ArmourPenetrationCoefficient) / 100.f;
+	const float EffectiveArmourCoefficient = FAuraCompiledCurves::Get().EvalCurve(CharacterClassInfo->DamageCalculationCoefficients, FName("EffectiveArmour"), TargetPlayerLevel);
 
-	const FRealCurve* EffectiveArmourCurve = CharacterClassInfo->DamageCalculationCoefficients->FindCurve(FName("EffectiveArmour"), FString());
-	const float EffectiveArmourCoefficient = EffectiveArmourCurve->Eval(TargetPlayerLevel);
-
-	// Armour ignores a percentage of incoming damage
-	Damage *= (100 - EffectiveArmour * EffectiveArmourCoefficient) / 100.f;
+	// Armour Penetration ignores a percentage of the Target's Armour, the remaining Armour ignores a percentage of incoming damage
+	Damage = FAuraDamageKernel::ApplyArmour(Damage, TargetArmour, SourceArmourPenetration, ArmourPenetrationCoefficient, EffectiveArmourCoefficient);
 
 	float SourceCriticalHitChance = 0.f;
 	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().CriticalHitChanceDef, EvaluationParameters, SourceCriticalHitChance);
@@ -233,17 +256,39 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().CriticalHitDamageDef, EvaluationParameters, SourceCriticalHitDamage);
 	SourceCriticalHitDamage = FMath::Max<float>(SourceCriticalHitDamage, 0.f);
 
-	const FRealCurve* CriticalHitResistanceCurve = CharacterClassInfo->DamageCalculationCoefficients->FindCurve(FName("CriticalHitResistance"), FString());
-	const float CriticalHitResistanceCoefficient = CriticalHitResistanceCurve->Eval(TargetPlayerLevel);
+	const float CriticalHitResistanceCoefficient = FAuraCompiledCurves::Get().EvalCurve(CharacterClassInfo->DamageCalculationCoefficients, FName("CriticalHitResistance"), TargetPlayerLevel);
 
 	// Target's Critical Hit Resistance reduces Source's Critical Hit Chance by a percentage
-	const float EffectiveCriticalHitChance = SourceCriticalHitChance - TargetCriticalHitResistance * CriticalHitResistanceCoefficient;
-	const bool bCriticalHit = FMath::RandRange(1, 100) < EffectiveCriticalHitChance;
+	const float EffectiveCriticalHitChance = FAuraDamageKernel::GetEffectiveCriticalHitChance(SourceCriticalHitChance, TargetCriticalHitResistance, CriticalHitResistanceCoefficient);
+	const bool bCriticalHit = RollStream.RandRange(1, 100) < EffectiveCriticalHitChance;
 
 	UAuraAbilitySystemLibrary::SetIsCriticalHit(EffectContextHandle, bCriticalHit);
 
-	Damage = bCriticalHit ? 2.f * Damage + SourceCriticalHitDamage : Damage;
+	Damage = FAuraDamageKernel::ApplyCriticalHit(Damage, bCriticalHit, SourceCriticalHitDamage);
 
 	const FGameplayModifierEvaluatedData EvaluatedData(UAuraAttributeSet::GetIncomingDamageAttribute(), EGameplayModOp::Additive, Damage);
 	OutExecuteOutput.AddOutputModifier(EvaluatedData);
+
+	FAuraTrace::DamageResolved(SourceASC, TargetASC, Damage, bBlocked, bCriticalHit);
+
+	UAuraCombatLogSubsystem* CombatLog = SourceAvatar->GetWorld()->GetSubsystem<UAuraCombatLogSubsystem>();
+	if (CombatLog && CombatLog->IsRecording())
+	{
+		FAuraCombatLogHit Hit;
+		Hit.Damage = ResistedDamage;
+		Hit.TargetBlockChance = TargetBlockChance;
+		Hit.TargetArmour = TargetArmour;
+		Hit.SourceArmourPenetration = SourceArmourPenetration;
+		Hit.ArmourPenetrationCoefficient = ArmourPenetrationCoefficient;
+		Hit.EffectiveArmourCoefficient = EffectiveArmourCoefficient;
+		Hit.SourceCriticalHitDamage = SourceCriticalHitDamage;
+		Hit.EffectiveCriticalHitChance = EffectiveCriticalHitChance;
+
+		EAuraCombatLogFlags Flags = EAuraCombatLogFlags::None;
+		if (bBlocked) Flags |= EAuraCombatLogFlags::BlockedHit;
+		if (bCriticalHit) Flags |= EAuraCombatLogFlags::CriticalHit;
+		if (UAuraAbilitySystemLibrary::IsSuccessfulDebuff(EffectContextHandle)) Flags |= EAuraCombatLogFlags::SuccessfulDebuff;
+
+		CombatLog->RecordHit(SourceASC, TargetASC, PrimaryDamageType, RollSeed, Hit, Flags, Damage);
+	}
 }
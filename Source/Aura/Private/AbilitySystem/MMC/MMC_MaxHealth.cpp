@@ -3,6 +3,7 @@
 
 #include "AbilitySystem/MMC/MMC_MaxHealth.h"
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
 
 #include "Interaction/CombatInterface.h"
 
@@ -35,5 +36,5 @@ float UMMC_MaxHealth::CalculateBaseMagnitude_Implementation(const FGameplayEffec
 		PlayerLevel = ICombatInterface::Execute_GetPlayerLevel(Spec.GetContext().GetSourceObject());
 	}
 
-	return 80.f + 2.5f * Vigor + 10.f * PlayerLevel;
+	return FAuraDamageKernel::GetMaxHealth(Vigor, PlayerLevel);
 }
@@ -0,0 +1,56 @@
+// Copyright Adam Thomas
+
+
+#include "AbilitySystem/Regen/AuraRegenSubsystem.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystemComponent.h"
+#include "GameFramework/Pawn.h"
+
+static TAutoConsoleVariable<float> CVarAuraRegenClientInterval(
+	TEXT("Aura.Regen.ClientInterval"),
+	0.1f,
+	TEXT("Seconds between local Health/Mana extrapolation updates on clients."));
+
+void UAuraRegenSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (AttributeSets.Num() == 0 || GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+	TimeSinceClientUpdate += DeltaTime;
+	if (TimeSinceClientUpdate < CVarAuraRegenClientInterval.GetValueOnGameThread()) return;
+	TimeSinceClientUpdate = 0.f;
+
+	for (auto It = AttributeSets.CreateIterator(); It; ++It)
+	{
+		UAuraAttributeSet* AttributeSet = It->Get();
+		if (AttributeSet == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// Authority sets are settled when read or modified, only a host's own vitals are kept moving for its HUD
+		if (AttributeSet->GetOwningActor()->HasAuthority())
+		{
+			const APawn* Avatar = Cast<APawn>(AttributeSet->GetOwningAbilitySystemComponent()->GetAvatarActor());
+			if (Avatar == nullptr || !Avatar->IsLocallyControlled()) continue;
+		}
+		AttributeSet->ExtrapolateRegen();
+	}
+}
+
+TStatId UAuraRegenSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraRegenSubsystem, STATGROUP_Tickables);
+}
+
+void UAuraRegenSubsystem::Register(UAuraAttributeSet* AttributeSet)
+{
+	AttributeSets.Add(AttributeSet);
+}
+
+bool UAuraRegenSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
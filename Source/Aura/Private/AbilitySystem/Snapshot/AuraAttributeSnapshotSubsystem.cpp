@@ -0,0 +1,123 @@
+// Copyright Adam Thomas
+
+
+#include "AbilitySystem/Snapshot/AuraAttributeSnapshotSubsystem.h"
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Aura/AuraLogChannels.h"
+
+static TAutoConsoleVariable<bool> CVarAuraAttributeSnapshot(
+	TEXT("Aura.AttributeSnapshot"),
+	true,
+	TEXT("Initialise enemy default attributes from cached per class and level snapshots instead of applying the default attribute effects."));
+
+static TAutoConsoleVariable<bool> CVarAuraAttributeSnapshotVerify(
+	TEXT("Aura.AttributeSnapshot.Verify"),
+	false,
+	TEXT("Always use the default attribute effects and log any attribute that differs from the cached snapshot."));
+
+bool UAuraAttributeSnapshotSubsystem::IsEnabled()
+{
+	return CVarAuraAttributeSnapshot.GetValueOnGameThread();
+}
+
+bool UAuraAttributeSnapshotSubsystem::ApplySnapshot(UAbilitySystemComponent* ASC, ECharacterClass CharacterClass, float Level, TSubclassOf<UGameplayEffect> SecondaryAttributes) const
+{
+	if (!IsEnabled() || CVarAuraAttributeSnapshotVerify.GetValueOnGameThread()) return false;
+
+	const TArray<float>* Values = Snapshots.Find(MakeTuple(CharacterClass, FMath::RoundToInt(Level)));
+	if (Values == nullptr || !FMath::IsNearlyEqual(Level, FMath::RoundToFloat(Level))) return false;
+
+	for (int32 Index = 0; Index < NumWrittenAttributes; ++Index)
+	{
+		ASC->SetNumericAttributeBase(Attributes[Index], (*Values)[Index]);
+	}
+
+	// The secondary attributes stay an infinite effect so anything that later changes a primary moves them too
+	if (SecondaryAttributes)
+	{
+		FGameplayEffectContextHandle ContextHandle = ASC->MakeEffectContext();
+		ContextHandle.AddSourceObject(ASC->GetAvatarActor());
+		const FGameplayEffectSpecHandle SpecHandle = ASC->MakeOutgoingSpec(SecondaryAttributes, Level, ContextHandle);
+		ASC->ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
+	}
+
+	for (int32 Index = NumWrittenAttributes + NumDerivedAttributes; Index < Attributes.Num(); ++Index)
+	{
+		ASC->SetNumericAttributeBase(Attributes[Index], (*Values)[Index]);
+	}
+	return true;
+}
+
+void UAuraAttributeSnapshotSubsystem::CaptureSnapshot(const UAbilitySystemComponent* ASC, ECharacterClass CharacterClass, float Level, TSubclassOf<UGameplayEffect> SecondaryAttributes)
+{
+	// Fractional levels scale curves between rows, only whole levels are worth sharing
+	if (!FMath::IsNearlyEqual(Level, FMath::RoundToFloat(Level))) return;
+
+	if (Attributes.Num() == 0)
+	{
+		BuildAttributeOrder(ASC, SecondaryAttributes);
+		if (Attributes.Num() == 0) return;
+	}
+
+	TArray<float> Values;
+	Values.Reserve(Attributes.Num());
+	for (const FGameplayAttribute& Attribute : Attributes)
+	{
+		Values.Add(ASC->GetNumericAttribute(Attribute));
+	}
+
+	const TTuple<ECharacterClass, int32> Key = MakeTuple(CharacterClass, FMath::RoundToInt(Level));
+	if (const TArray<float>* Existing = Snapshots.Find(Key))
+	{
+		for (int32 Index = 0; Index < Attributes.Num(); ++Index)
+		{
+			if (!FMath::IsNearlyEqual((*Existing)[Index], Values[Index]))
+			{
+				UE_LOG(LogAura, Warning, TEXT("Attribute snapshot mismatch for class %d level %d: %s snapshot %f, effects %f"),
+					static_cast<int32>(CharacterClass), Key.Value, *Attributes[Index].GetName(), (*Existing)[Index], Values[Index]);
+			}
+		}
+		return;
+	}
+
+	Snapshots.Add(Key, MoveTemp(Values));
+}
+
+void UAuraAttributeSnapshotSubsystem::BuildAttributeOrder(const UAbilitySystemComponent* ASC, TSubclassOf<UGameplayEffect> SecondaryAttributes)
+{
+	const UAuraAttributeSet* AuraAS = ASC->GetSet<UAuraAttributeSet>();
+	if (AuraAS == nullptr) return;
+
+	TArray<FGameplayAttribute> DerivedAttributes;
+	if (SecondaryAttributes)
+	{
+		for (const FGameplayModifierInfo& Modifier : SecondaryAttributes.GetDefaultObject()->Modifiers)
+		{
+			DerivedAttributes.AddUnique(Modifier.Attribute);
+		}
+	}
+
+	for (const TPair<FGameplayTag, TStaticFuncPtr<FGameplayAttribute()>>& Pair : AuraAS->TagsToAttributes)
+	{
+		const FGameplayAttribute Attribute = Pair.Value();
+		if (!DerivedAttributes.Contains(Attribute))
+		{
+			Attributes.Add(Attribute);
+		}
+	}
+	NumWrittenAttributes = Attributes.Num();
+
+	for (const FGameplayAttribute& Attribute : DerivedAttributes)
+	{
+		if (Attribute != UAuraAttributeSet::GetHealthAttribute() && Attribute != UAuraAttributeSet::GetManaAttribute())
+		{
+			Attributes.Add(Attribute);
+		}
+	}
+	NumDerivedAttributes = Attributes.Num() - NumWrittenAttributes;
+
+	Attributes.Add(UAuraAttributeSet::GetHealthAttribute());
+	Attributes.Add(UAuraAttributeSet::GetManaAttribute());
+}
@@ -0,0 +1,97 @@
+// Copyright Adam Thomas
+
+
+#include "AbilitySystem/XP/AuraXPLedgerSubsystem.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "Character/AuraCharacterBase.h"
+#include "Interaction/PlayerInterface.h"
+
+static TAutoConsoleVariable<float> CVarAuraXPShareRadius(
+	TEXT("Aura.XP.ShareRadius"),
+	0.f,
+	TEXT("Kill XP is split evenly between live players within this radius of the victim. 0 gives all XP to the killer."));
+
+void UAuraXPLedgerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	Flush();
+}
+
+TStatId UAuraXPLedgerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraXPLedgerSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraXPLedgerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraXPLedgerSubsystem::AddKillXP(AActor* Killer, const AActor* Victim, int32 XPReward)
+{
+	if (XPReward <= 0) return;
+
+	const float ShareRadius = CVarAuraXPShareRadius.GetValueOnGameThread();
+	if (ShareRadius <= 0.f || !IsValid(Victim))
+	{
+		AddXP(Killer, XPReward);
+		return;
+	}
+
+	TArray<AActor*> NearbyActors;
+	UAuraAbilitySystemLibrary::GetLivePlayersWithinRadius(Victim, NearbyActors, TArray<AActor*>(), ShareRadius, Victim->GetActorLocation());
+
+	TArray<AActor*, TInlineAllocator<4>> Recipients;
+	for (AActor* Actor : NearbyActors)
+	{
+		if (Actor && Actor->Implements<UPlayerInterface>())
+		{
+			Recipients.Add(Actor);
+		}
+	}
+	if (IsValid(Killer) && Killer->Implements<UPlayerInterface>())
+	{
+		Recipients.AddUnique(Killer);
+	}
+	if (Recipients.Num() == 0) return;
+
+	// Shares are floored so they sum to XPReward, the killer (or the first recipient if the killer is not a player) gets the remainder
+	const int32 Share = XPReward / Recipients.Num();
+	const int32 Remainder = XPReward - Share * Recipients.Num();
+	AActor* RemainderRecipient = Recipients.Contains(Killer) ? Killer : Recipients[0];
+	for (AActor* Recipient : Recipients)
+	{
+		const int32 RecipientXP = Recipient == RemainderRecipient ? Share + Remainder : Share;
+		if (RecipientXP > 0)
+		{
+			AddXP(Recipient, RecipientXP);
+		}
+	}
+}
+
+void UAuraXPLedgerSubsystem::AddXP(AActor* Recipient, int32 XP)
+{
+	if (!IsValid(Recipient) || !Recipient->Implements<UPlayerInterface>()) return;
+	PendingXP.FindOrAdd(Recipient) += XP;
+}
+
+void UAuraXPLedgerSubsystem::Flush()
+{
+	if (PendingXP.Num() == 0) return;
+
+	// Granting XP can level up and apply effects, so work from a copy in case that feeds back into the ledger
+	TMap<TWeakObjectPtr<AActor>, int32> XPToGrant = MoveTemp(PendingXP);
+	PendingXP.Reset();
+
+	for (const TPair<TWeakObjectPtr<AActor>, int32>& Pair : XPToGrant)
+	{
+		AAuraCharacterBase* Recipient = Cast<AAuraCharacterBase>(Pair.Key.Get());
+		if (Recipient == nullptr) continue;
+
+		if (UAuraAttributeSet* AuraAS = Cast<UAuraAttributeSet>(Recipient->GetAttributeSet()))
+		{
+			AuraAS->GrantXP(Recipient, Pair.Value);
+		}
+	}
+}
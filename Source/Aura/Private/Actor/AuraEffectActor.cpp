@@ -6,11 +6,20 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemInterface.h"
 
+static TAutoConsoleVariable<bool> CVarAuraEffectActorDormancy(
+	TEXT("Aura.EffectActor.Dormancy"),
+	true,
+	TEXT("Keep effect actors net dormant until they are consumed or destroyed. Read when each actor begins play."));
+
 
 AAuraEffectActor::AAuraEffectActor()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// Nothing about a pickup changes until it is consumed, placed ones are never sent and spawned ones go dormant in BeginPlay
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	SetRootComponent(CreateDefaultSubobject<USceneComponent>("SceneRoot"));
 
 }
@@ -21,9 +30,22 @@ void AAuraEffectActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (!HasAuthority()) return;
+
+	if (!CVarAuraEffectActorDormancy.GetValueOnGameThread())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+	else if (!IsNetStartupActor())
+	{
+		// Replicated once to each connection, then dormant
+		SetNetDormancy(DORM_DormantAll);
+	}
 }
+
 void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGameplayEffect> GameplayEffectClass)
 {
+	if (!HasAuthority()) return;
 	if (TargetActor->ActorHasTag(FName("Enemy")) && !bApplyEffectsToEnemies) return;
 
 	UAbilitySystemComponent* TargetAbilitySystemComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
@@ -40,7 +62,7 @@ void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGam
 
 	if (bIsInfinite && InfiniteEffectRemovalPolicy == EEffectRemovalPolicy::RemoveOnEndOverlap)
 	{
-		ActiveEffectHandles.Add(ActiveEffectHandle, TargetAbilitySystemComponent);
+		ActiveEffectHandles.FindOrAdd(TargetAbilitySystemComponent).Add(ActiveEffectHandle);
 	}
 
 	if (bDestroyOnEffectApplication && !bIsInfinite)
@@ -52,11 +74,19 @@ void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGam
 
 void AAuraEffectActor::OnOverlap(AActor* TargetActor)
 {
+	if (!HasAuthority()) return;
 	if (TargetActor->ActorHasTag(FName("Enemy")) && !bApplyEffectsToEnemies) return;
 
 	if (InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
 	{
-		ApplyEffectToTarget(TargetActor, InstantGameplayEffectClass);
+		if (PeriodicApplicationInterval > 0.f)
+		{
+			AddPeriodicTarget(TargetActor);
+		}
+		else
+		{
+			ApplyEffectToTarget(TargetActor, InstantGameplayEffectClass);
+		}
 	}
 
 	if (DurationEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
@@ -72,8 +102,14 @@ void AAuraEffectActor::OnOverlap(AActor* TargetActor)
 
 void AAuraEffectActor::OnEndOverlap(AActor* TargetActor)
 {
+	if (!HasAuthority()) return;
 	if (TargetActor->ActorHasTag(FName("Enemy")) && !bApplyEffectsToEnemies) return;
 
+	if (PeriodicApplicationInterval > 0.f)
+	{
+		RemovePeriodicTarget(TargetActor);
+	}
+
 	if (InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnEndOverlap)
 	{
 		ApplyEffectToTarget(TargetActor, InstantGameplayEffectClass);
@@ -94,18 +130,66 @@ void AAuraEffectActor::OnEndOverlap(AActor* TargetActor)
 		UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
 		if (!IsValid(TargetASC)) return;
 
-		TArray<FActiveGameplayEffectHandle> HandlesToRemove;
-		for (TTuple<FActiveGameplayEffectHandle, UAbilitySystemComponent*> HandlePair : ActiveEffectHandles)
+		TArray<FActiveGameplayEffectHandle, TInlineAllocator<2>> HandlesToRemove;
+		if (ActiveEffectHandles.RemoveAndCopyValue(TargetASC, HandlesToRemove))
 		{
-			if (TargetASC == HandlePair.Value)
+			for (const FActiveGameplayEffectHandle& Handle : HandlesToRemove)
 			{
-				TargetASC->RemoveActiveGameplayEffect(HandlePair.Key, 1);
-				HandlesToRemove.Add(HandlePair.Key);
+				TargetASC->RemoveActiveGameplayEffect(Handle, 1);
 			}
 		}
-		for (FActiveGameplayEffectHandle& Handle : HandlesToRemove)
-		{
-			ActiveEffectHandles.FindAndRemoveChecked(Handle);
-		}
+	}
+}
+
+void AAuraEffectActor::AddPeriodicTarget(AActor* TargetActor)
+{
+	UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
+	if (TargetASC == nullptr) return;
+
+	PeriodicTargets.AddUnique(TargetASC);
+
+	// One timer for everyone inside, newcomers are hit on its next tick
+	if (!GetWorldTimerManager().IsTimerActive(PeriodicApplicationTimer))
+	{
+		GetWorldTimerManager().SetTimer(PeriodicApplicationTimer, this, &AAuraEffectActor::ApplyPeriodicEffect, PeriodicApplicationInterval, true);
+	}
+}
+
+void AAuraEffectActor::RemovePeriodicTarget(AActor* TargetActor)
+{
+	PeriodicTargets.RemoveSwap(UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor));
+	if (PeriodicTargets.Num() == 0)
+	{
+		GetWorldTimerManager().ClearTimer(PeriodicApplicationTimer);
+	}
+}
+
+void AAuraEffectActor::ApplyPeriodicEffect()
+{
+	PeriodicTargets.RemoveAllSwap([](const TWeakObjectPtr<UAbilitySystemComponent>& Target) { return !Target.IsValid(); });
+	if (PeriodicTargets.Num() == 0)
+	{
+		GetWorldTimerManager().ClearTimer(PeriodicApplicationTimer);
+		return;
+	}
+
+	check(InstantGameplayEffectClass);
+
+	// Copied as a target dying can end its overlap while the batch is applied
+	const TArray<TWeakObjectPtr<UAbilitySystemComponent>> Targets = PeriodicTargets;
+	for (const TWeakObjectPtr<UAbilitySystemComponent>& Target : Targets)
+	{
+		if (!Target.IsValid()) continue;
+
+		// Each target is the source of its own spec, as ApplyEffectToTarget does
+		FGameplayEffectContextHandle EffectContextHandle = Target->MakeEffectContext();
+		EffectContextHandle.AddSourceObject(this);
+		const FGameplayEffectSpecHandle EffectSpecHandle = Target->MakeOutgoingSpec(InstantGameplayEffectClass, ActorLevel, EffectContextHandle);
+		Target->ApplyGameplayEffectSpecToSelf(*EffectSpecHandle.Data.Get());
+	}
+
+	if (bDestroyOnEffectApplication)
+	{
+		Destroy();
 	}
 }
@@ -0,0 +1,499 @@
+// Copyright Adam Thomas
+
+
+#include "Actor/AuraPickupManager.h"
+#include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystemComponent.h"
+#include "Character/AuraCharacterBase.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+#include "Aura/Aura.h"
+#include "Aura/AuraLogChannels.h"
+#include "Aura/AuraStats.h"
+
+namespace AuraPickupManager
+{
+	// Type of the records a client has not received yet when a later batch arrives first
+	static constexpr uint8 PendingType = MAX_uint8;
+}
+
+void FAuraPickupBatch::PostReplicatedAdd(const FAuraPickupBatchArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->AddBatch(*this);
+	}
+}
+
+void FAuraConsumedPickup::PostReplicatedAdd(const FAuraConsumedPickupArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->MarkConsumed(Pickup);
+	}
+}
+
+
+AAuraPickupManager::AAuraPickupManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// Its pickups are spread over the map wherever the manager itself stands, so distance relevancy would cull them
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetDormancy = DORM_Initial;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>("SceneRoot"));
+
+	AddedPickups.Owner = this;
+	ConsumedPickups.Owner = this;
+}
+
+void AAuraPickupManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AAuraPickupManager, AddedPickups);
+	DOREPLIFETIME(AAuraPickupManager, ConsumedPickups);
+}
+
+void AAuraPickupManager::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+#if WITH_EDITOR
+	// Editor preview, game worlds build their instances in BeginPlay
+	if (!GetWorld()->IsGameWorld())
+	{
+		RebuildInstances();
+	}
+#endif
+}
+
+void AAuraPickupManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Clients may already have received batches and consumed pickups before beginning play
+	SetNumPickups(Pickups.Num());
+	RebuildInstances();
+	INC_DWORD_STAT_BY(STAT_AuraInstancedPickups, Pickups.Num());
+
+	if (!HasAuthority()) return;
+
+	if (!IsNetStartupActor())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	BuildSpatialHash();
+	SetActorTickInterval(OverlapInterval);
+	SetActorTickEnabled(true);
+
+	UE_LOG(LogAura, Log, TEXT("%s: %d pickups of %d types in %d cells, %llu bytes of records and bookkeeping"),
+		*GetName(), Pickups.Num(), PickupTypes.Num(), SpatialHash.Num(), static_cast<uint64>(GetBookkeepingSize()));
+}
+
+void AAuraPickupManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_AuraInstancedPickups, Pickups.Num());
+	Super::EndPlay(EndPlayReason);
+}
+
+void AAuraPickupManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!HasAuthority()) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_AuraPickupOverlap);
+
+	TArray<AActor*> Targets;
+	GatherTargets(Targets);
+
+	for (FAuraPickupOccupant& Occupant : Occupants)
+	{
+		Occupant.bStillOverlapping = false;
+	}
+
+	// Collected first as applying an effect can consume a pickup and change the buckets
+	TArray<TPair<AActor*, int32>, TInlineAllocator<8>> NewOverlaps;
+	for (AActor* Target : Targets)
+	{
+		const FVector3f Location(Target->GetActorLocation());
+		const FIntPoint Cell = GetCell(Location);
+		for (int32 Y = Cell.Y - 1; Y <= Cell.Y + 1; ++Y)
+		{
+			for (int32 X = Cell.X - 1; X <= Cell.X + 1; ++X)
+			{
+				const TArray<int32>* Bucket = SpatialHash.Find(FIntPoint(X, Y));
+				if (Bucket == nullptr) continue;
+
+				for (const int32 PickupIndex : *Bucket)
+				{
+					const FAuraPickupRecord& Pickup = Pickups[PickupIndex];
+					const float Radius = PickupTypes[Pickup.Type].Radius;
+					if (FVector3f::DistSquaredXY(Location, Pickup.Location) > Radius * Radius || FMath::Abs(Location.Z - Pickup.Location.Z) > HeightTolerance) continue;
+
+					FAuraPickupOccupant* Occupant = Occupants.FindByPredicate([Target, PickupIndex](const FAuraPickupOccupant& Existing)
+					{
+						return Existing.Pickup == PickupIndex && Existing.Target.Get() == Target;
+					});
+					if (Occupant)
+					{
+						Occupant->bStillOverlapping = true;
+					}
+					else
+					{
+						NewOverlaps.Emplace(Target, PickupIndex);
+					}
+				}
+			}
+		}
+	}
+
+	for (int32 Index = Occupants.Num() - 1; Index >= 0; --Index)
+	{
+		if (Occupants[Index].bStillOverlapping) continue;
+
+		FAuraPickupOccupant Occupant = MoveTemp(Occupants[Index]);
+		Occupants.RemoveAtSwap(Index, 1, false);
+		if (Occupant.Target.IsValid())
+		{
+			OnEndOverlap(Occupant);
+		}
+	}
+
+	for (const TPair<AActor*, int32>& NewOverlap : NewOverlaps)
+	{
+		if (Consumed[NewOverlap.Value]) continue;
+
+		FAuraPickupOccupant& Occupant = Occupants.AddDefaulted_GetRef();
+		Occupant.Target = NewOverlap.Key;
+		Occupant.Pickup = NewOverlap.Value;
+		Occupant.bStillOverlapping = true;
+		OnOverlap(Occupant);
+	}
+
+	// Like a destroyed effect actor, a consumed pickup sends no end overlaps to whoever else was inside it
+	Occupants.RemoveAllSwap([this](const FAuraPickupOccupant& Occupant) { return Consumed[Occupant.Pickup]; });
+}
+
+int32 AAuraPickupManager::AddPickup(int32 Type, const FVector& Location)
+{
+	return AddPickupGrid(Type, Location, 1, 1, 0.f);
+}
+
+int32 AAuraPickupManager::AddPickupGrid(int32 Type, const FVector& Corner, int32 Columns, int32 Count, float Spacing)
+{
+	if (!HasAuthority() || !PickupTypes.IsValidIndex(Type) || Count <= 0) return INDEX_NONE;
+
+	FlushNetDormancy();
+
+	FAuraPickupBatch& Batch = AddedPickups.Items.AddDefaulted_GetRef();
+	Batch.Corner = FVector3f(Corner);
+	Batch.Spacing = Spacing;
+	Batch.FirstPickup = Pickups.Num();
+	Batch.Count = Count;
+	Batch.Columns = FMath::Max(Columns, 1);
+	Batch.Type = static_cast<uint8>(Type);
+	AddedPickups.MarkItemDirty(Batch);
+
+	AddBatch(Batch);
+	return Batch.FirstPickup;
+}
+
+void AAuraPickupManager::AddBatch(const FAuraPickupBatch& Batch)
+{
+	SetNumPickups(FMath::Max(Pickups.Num(), Batch.FirstPickup + Batch.Count));
+
+	for (int32 Index = 0; Index < Batch.Count; ++Index)
+	{
+		FAuraPickupRecord& Pickup = Pickups[Batch.FirstPickup + Index];
+		Pickup.Location = Batch.Corner + FVector3f((Index % Batch.Columns) * Batch.Spacing, (Index / Batch.Columns) * Batch.Spacing, 0.f);
+		Pickup.Type = Batch.Type;
+	}
+
+	// Before BeginPlay the hash, instances and stats are built from the whole array
+	if (!HasActorBegunPlay()) return;
+
+	AddInstances(Batch.FirstPickup, Batch.Count);
+	if (HasAuthority())
+	{
+		for (int32 PickupIndex = Batch.FirstPickup; PickupIndex < Batch.FirstPickup + Batch.Count; ++PickupIndex)
+		{
+			AddToSpatialHash(PickupIndex);
+		}
+	}
+}
+
+void AAuraPickupManager::MarkConsumed(int32 PickupIndex)
+{
+	if (PickupIndex < 0) return;
+
+	// A pickup consumed before its batch arrives is skipped when the batch adds its instances
+	SetNumPickups(FMath::Max(Pickups.Num(), PickupIndex + 1));
+	Consumed[PickupIndex] = true;
+	HideInstance(PickupIndex);
+}
+
+void AAuraPickupManager::SetNumPickups(int32 NumPickups)
+{
+	if (NumPickups > Pickups.Num() && HasActorBegunPlay())
+	{
+		INC_DWORD_STAT_BY(STAT_AuraInstancedPickups, NumPickups - Pickups.Num());
+	}
+	for (int32 PickupIndex = Pickups.Num(); PickupIndex < NumPickups; ++PickupIndex)
+	{
+		Pickups.AddDefaulted_GetRef().Type = AuraPickupManager::PendingType;
+	}
+	Consumed.Add(false, FMath::Max(Pickups.Num() - Consumed.Num(), 0));
+	InstanceIndices.Add(INDEX_NONE, FMath::Max(Pickups.Num() - InstanceIndices.Num(), 0));
+}
+
+FIntPoint AAuraPickupManager::GetCell(const FVector3f& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void AAuraPickupManager::BuildSpatialHash()
+{
+	float MaxRadius = 0.f;
+	bAnyTypeAppliesToEnemies = false;
+	for (const FAuraPickupType& Type : PickupTypes)
+	{
+		MaxRadius = FMath::Max(MaxRadius, Type.Radius);
+		bAnyTypeAppliesToEnemies |= Type.bApplyEffectsToEnemies;
+	}
+	CellSize = FMath::Max3(CellSize, MaxRadius, 1.f);
+
+	SpatialHash.Reset();
+	for (int32 PickupIndex = 0; PickupIndex < Pickups.Num(); ++PickupIndex)
+	{
+		if (!Consumed[PickupIndex])
+		{
+			AddToSpatialHash(PickupIndex);
+		}
+	}
+}
+
+void AAuraPickupManager::AddToSpatialHash(int32 PickupIndex)
+{
+	if (!PickupTypes.IsValidIndex(Pickups[PickupIndex].Type))
+	{
+		UE_LOG(LogAura, Warning, TEXT("%s: pickup %d has no type %d, it is ignored"), *GetName(), PickupIndex, Pickups[PickupIndex].Type);
+		return;
+	}
+	SpatialHash.FindOrAdd(GetCell(Pickups[PickupIndex].Location)).Add(PickupIndex);
+}
+
+void AAuraPickupManager::RemoveFromSpatialHash(int32 PickupIndex)
+{
+	const FIntPoint Cell = GetCell(Pickups[PickupIndex].Location);
+	if (TArray<int32>* Bucket = SpatialHash.Find(Cell))
+	{
+		Bucket->RemoveSingleSwap(PickupIndex, false);
+		if (Bucket->Num() == 0)
+		{
+			SpatialHash.Remove(Cell);
+		}
+	}
+}
+
+void AAuraPickupManager::GatherTargets(TArray<AActor*>& OutTargets) const
+{
+	if (bAnyTypeAppliesToEnemies)
+	{
+		for (TActorIterator<AAuraCharacterBase> It(GetWorld()); It; ++It)
+		{
+			OutTargets.Add(*It);
+		}
+		return;
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			OutTargets.Add(PlayerController->GetPawn());
+		}
+	}
+}
+
+void AAuraPickupManager::OnOverlap(FAuraPickupOccupant& Occupant)
+{
+	const FAuraPickupType& Type = PickupTypes[Pickups[Occupant.Pickup].Type];
+	if (Occupant.Target->ActorHasTag(FName("Enemy")) && !Type.bApplyEffectsToEnemies) return;
+
+	if (Type.InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
+	{
+		ApplyEffectToTarget(Occupant, Type.InstantGameplayEffectClass);
+	}
+
+	if (Type.DurationEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
+	{
+		ApplyEffectToTarget(Occupant, Type.DurationGameplayEffectClass);
+	}
+
+	if (Type.InfiniteEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
+	{
+		ApplyEffectToTarget(Occupant, Type.InfiniteGameplayEffectClass);
+	}
+}
+
+void AAuraPickupManager::OnEndOverlap(FAuraPickupOccupant& Occupant)
+{
+	const FAuraPickupType& Type = PickupTypes[Pickups[Occupant.Pickup].Type];
+	if (Occupant.Target->ActorHasTag(FName("Enemy")) && !Type.bApplyEffectsToEnemies) return;
+
+	if (Type.InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnEndOverlap)
+	{
+		ApplyEffectToTarget(Occupant, Type.InstantGameplayEffectClass);
+	}
+
+	if (Type.DurationEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnEndOverlap)
+	{
+		ApplyEffectToTarget(Occupant, Type.DurationGameplayEffectClass);
+	}
+
+	if (Type.InfiniteEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnEndOverlap)
+	{
+		ApplyEffectToTarget(Occupant, Type.InfiniteGameplayEffectClass);
+	}
+
+	if (Type.InfiniteEffectRemovalPolicy == EEffectRemovalPolicy::RemoveOnEndOverlap)
+	{
+		UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Occupant.Target.Get());
+		if (!IsValid(TargetASC)) return;
+
+		for (const FActiveGameplayEffectHandle& Handle : Occupant.InfiniteHandles)
+		{
+			TargetASC->RemoveActiveGameplayEffect(Handle, 1);
+		}
+		Occupant.InfiniteHandles.Reset();
+	}
+}
+
+void AAuraPickupManager::ApplyEffectToTarget(FAuraPickupOccupant& Occupant, TSubclassOf<UGameplayEffect> GameplayEffectClass)
+{
+	const FAuraPickupType& Type = PickupTypes[Pickups[Occupant.Pickup].Type];
+
+	UAbilitySystemComponent* TargetAbilitySystemComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Occupant.Target.Get());
+	if (TargetAbilitySystemComponent == nullptr) return;
+
+	check(GameplayEffectClass);
+	FGameplayEffectContextHandle EffectContextHandle = TargetAbilitySystemComponent->MakeEffectContext();
+	EffectContextHandle.AddSourceObject(this);
+	const FGameplayEffectSpecHandle EffectSpecHandle = TargetAbilitySystemComponent->MakeOutgoingSpec(GameplayEffectClass, Type.ActorLevel, EffectContextHandle);
+	const FActiveGameplayEffectHandle ActiveEffectHandle = TargetAbilitySystemComponent->ApplyGameplayEffectSpecToSelf(*EffectSpecHandle.Data.Get());
+
+	const bool bIsInfinite = EffectSpecHandle.Data.Get()->Def.Get()->DurationPolicy == EGameplayEffectDurationType::Infinite;
+
+	if (bIsInfinite && Type.InfiniteEffectRemovalPolicy == EEffectRemovalPolicy::RemoveOnEndOverlap)
+	{
+		Occupant.InfiniteHandles.Add(ActiveEffectHandle);
+	}
+
+	if (Type.bDestroyOnEffectApplication && !bIsInfinite)
+	{
+		Consume(Occupant.Pickup);
+	}
+}
+
+void AAuraPickupManager::Consume(int32 PickupIndex)
+{
+	if (Consumed[PickupIndex]) return;
+
+	FlushNetDormancy();
+
+	FAuraConsumedPickup& Item = ConsumedPickups.Items.AddDefaulted_GetRef();
+	Item.Pickup = PickupIndex;
+	ConsumedPickups.MarkItemDirty(Item);
+
+	RemoveFromSpatialHash(PickupIndex);
+	MarkConsumed(PickupIndex);
+}
+
+void AAuraPickupManager::RebuildInstances()
+{
+#if WITH_AURA_COSMETICS
+	for (UInstancedStaticMeshComponent* Component : InstanceComponents)
+	{
+		if (Component) Component->DestroyComponent();
+	}
+	InstanceComponents.Reset();
+	InstanceIndices.Init(INDEX_NONE, Pickups.Num());
+
+	for (int32 TypeIndex = 0; TypeIndex < PickupTypes.Num(); ++TypeIndex)
+	{
+		UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(this, NAME_None, RF_Transient);
+		Component->SetStaticMesh(PickupTypes[TypeIndex].Mesh);
+		Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Component->SetupAttachment(GetRootComponent());
+		Component->RegisterComponent();
+		InstanceComponents.Add(Component);
+	}
+
+	AddInstances(0, Pickups.Num());
+#endif
+}
+
+void AAuraPickupManager::AddInstances(int32 FirstPickup, int32 Count)
+{
+#if WITH_AURA_COSMETICS
+	TArray<TArray<FTransform>> TypeTransforms;
+	TArray<TArray<int32>> TypePickups;
+	TypeTransforms.SetNum(InstanceComponents.Num());
+	TypePickups.SetNum(InstanceComponents.Num());
+	for (int32 PickupIndex = FirstPickup; PickupIndex < FirstPickup + Count; ++PickupIndex)
+	{
+		const FAuraPickupRecord& Pickup = Pickups[PickupIndex];
+		if (!InstanceComponents.IsValidIndex(Pickup.Type) || (Consumed.IsValidIndex(PickupIndex) && Consumed[PickupIndex])) continue;
+
+		TypeTransforms[Pickup.Type].Add(FTransform(FVector(Pickup.Location)));
+		TypePickups[Pickup.Type].Add(PickupIndex);
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < InstanceComponents.Num(); ++TypeIndex)
+	{
+		if (TypeTransforms[TypeIndex].Num() == 0 || InstanceComponents[TypeIndex] == nullptr) continue;
+
+		const TArray<int32> Instances = InstanceComponents[TypeIndex]->AddInstances(TypeTransforms[TypeIndex], true, true);
+		for (int32 Index = 0; Index < Instances.Num(); ++Index)
+		{
+			InstanceIndices[TypePickups[TypeIndex][Index]] = Instances[Index];
+		}
+	}
+#endif
+}
+
+void AAuraPickupManager::HideInstance(int32 PickupIndex)
+{
+#if WITH_AURA_COSMETICS
+	if (!InstanceIndices.IsValidIndex(PickupIndex) || InstanceIndices[PickupIndex] == INDEX_NONE) return;
+
+	const FAuraPickupRecord& Pickup = Pickups[PickupIndex];
+	if (InstanceComponents.IsValidIndex(Pickup.Type) && InstanceComponents[Pickup.Type])
+	{
+		// Scaled to nothing rather than removed so the other instance indices stay put
+		const FTransform HiddenTransform(FQuat::Identity, FVector(Pickup.Location), FVector::ZeroVector);
+		InstanceComponents[Pickup.Type]->UpdateInstanceTransform(InstanceIndices[PickupIndex], HiddenTransform, true, true);
+	}
+	InstanceIndices[PickupIndex] = INDEX_NONE;
+#endif
+}
+
+SIZE_T AAuraPickupManager::GetBookkeepingSize() const
+{
+	SIZE_T Size = Pickups.GetAllocatedSize() + AddedPickups.Items.GetAllocatedSize() + ConsumedPickups.Items.GetAllocatedSize() + InstanceIndices.GetAllocatedSize()
+		+ Consumed.GetAllocatedSize() + SpatialHash.GetAllocatedSize() + Occupants.GetAllocatedSize();
+	for (const TPair<FIntPoint, TArray<int32>>& Bucket : SpatialHash)
+	{
+		Size += Bucket.Value.GetAllocatedSize();
+	}
+	return Size;
+}
@@ -3,7 +3,8 @@
 
 #include "Actor/AuraProjectile.h"
 
-#include "NiagaraFunctionLibrary.h"
+#include "Game/AuraVFXSubsystem.h"
+#include "Game/AuraAudioSubsystem.h"
 #include "Aura/Aura.h"
 #include "Components/AudioComponent.h"
 #include "Components/SphereComponent.h"
@@ -12,6 +13,7 @@
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystem/AuraAbilitySystemLibrary.h"
 #include "AbilitySystemComponent.h"
+#include "Aura/AuraStats.h"
 
 AAuraProjectile::AAuraProjectile()
 {
@@ -38,14 +40,23 @@ AAuraProjectile::AAuraProjectile()
 void AAuraProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+	INC_DWORD_STAT(STAT_AuraProjectilesSpawned);
+	INC_DWORD_STAT(STAT_AuraLiveProjectiles);
 	SetLifeSpan(LifeSpan);
 	Sphere->OnComponentBeginOverlap.AddUniqueDynamic(this, &AAuraProjectile::OnSphereOverlap);
-	LoopingSoundComponent = UGameplayStatics::SpawnSoundAttached(LoopingSound, GetRootComponent());
+#if WITH_AURA_COSMETICS
+	if (UAuraAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UAuraAudioSubsystem>())
+	{
+		LoopingSoundComponent = AudioSubsystem->AcquireLoopingSound(LoopingSound, GetRootComponent());
+	}
+#endif
 }
 
 void AAuraProjectile::Destroyed()
 {
 	if (!bHit && !HasAuthority()) OnHit();
+	ReleaseLoopingSound();
+	DEC_DWORD_STAT(STAT_AuraLiveProjectiles);
 
 	Super::Destroyed();
 }
@@ -53,6 +64,7 @@ void AAuraProjectile::Destroyed()
 void AAuraProjectile::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
 	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraProjectileOverlap);
 	AActor* SourceAvatarActor = DamageEffectParams.SourceAbilitySystemComponent->GetAvatarActor();
 
 	if (SourceAvatarActor == OtherActor) return;
@@ -78,8 +90,27 @@ void AAuraProjectile::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent,
 
 void AAuraProjectile::OnHit()
 {
-	UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation(), FRotator::ZeroRotator);
-	UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, ImpactEffect, GetActorLocation());
-	if (LoopingSoundComponent)	LoopingSoundComponent->Stop();
+#if WITH_AURA_COSMETICS
+	if (UAuraAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UAuraAudioSubsystem>())
+	{
+		AudioSubsystem->PlayCombatSound(ImpactSound, GetActorLocation());
+	}
+	if (UAuraVFXSubsystem* VFXSubsystem = GetWorld()->GetSubsystem<UAuraVFXSubsystem>())
+	{
+		VFXSubsystem->SpawnImpactEffect(ImpactEffect, GetActorLocation());
+	}
+#endif
+	ReleaseLoopingSound();
 	bHit = true;
 }
+
+void AAuraProjectile::ReleaseLoopingSound()
+{
+	if (LoopingSoundComponent == nullptr) return;
+
+	if (UAuraAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UAuraAudioSubsystem>())
+	{
+		AudioSubsystem->ReleaseLoopingSound(LoopingSoundComponent);
+	}
+	LoopingSoundComponent = nullptr;
+}
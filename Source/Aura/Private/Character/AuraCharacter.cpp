@@ -2,6 +2,7 @@
 
 
 #include "Character/AuraCharacter.h"
+#include "Aura/Aura.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "Player/AuraPlayerState.h"
@@ -24,9 +25,11 @@ AAuraCharacter::AAuraCharacter()
 	TopDownCameraComponent->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
 	TopDownCameraComponent->bUsePawnControlRotation = false;
 
+#if WITH_AURA_COSMETICS
 	LevelUpNiagaraComponent = CreateDefaultSubobject<UNiagaraComponent>("LevelUpNiagaraComponent");
 	LevelUpNiagaraComponent->SetupAttachment(GetRootComponent());
 	LevelUpNiagaraComponent->bAutoActivate = false;
+#endif
 
 
 	GetCharacterMovement()->bOrientRotationToMovement = true;
@@ -7,19 +7,31 @@
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "NiagaraSystem.h"
 #include "AbilitySystem/Debuff/DebuffNiagaraComponent.h"
 #include "AuraGameplayTags.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Character/AuraCorpseSubsystem.h"
+#include "Character/AuraDissolveSubsystem.h"
+#include "Game/AuraVFXSubsystem.h"
+#include "Game/AuraAudioSubsystem.h"
+
+static TAutoConsoleVariable<float> CVarAuraDeathCosmeticWindow(
+	TEXT("Aura.Death.CosmeticWindow"),
+	1.f,
+	TEXT("Clients learning about a death later than this many seconds after it happened skip the death sound and impulse."));
+
+static TAutoConsoleVariable<bool> CVarAuraNativeDissolve(
+	TEXT("Aura.Dissolve.Native"),
+	true,
+	TEXT("Drive death dissolves from UAuraDissolveSubsystem instead of per death MIDs and Blueprint timelines."));
 
 
 AAuraCharacterBase::AAuraCharacterBase()
 {
 	PrimaryActorTick.bCanEverTick = false;
-	const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
-
-	BurnDebuffComponent = CreateDefaultSubobject<UDebuffNiagaraComponent>("BurnDebuffComponent");
-	BurnDebuffComponent->SetupAttachment(GetRootComponent());
-	BurnDebuffComponent->DebuffTag = GameplayTags.Debuff_Burn;
 
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 	GetCapsuleComponent()->SetGenerateOverlapEvents(false);
@@ -31,6 +43,8 @@ AAuraCharacterBase::AAuraCharacterBase()
 	Weapon->SetupAttachment(GetMesh(), FName("WeaponHandSocket"));
 	Weapon->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
+	BurnDebuffComponent = CreateDefaultSubobject<UDebuffNiagaraComponent>("BurnDebuffComponent");
+	BurnDebuffComponent->SetupAttachment(GetRootComponent());
 }
 
 UAbilitySystemComponent* AAuraCharacterBase::GetAbilitySystemComponent() const
@@ -38,20 +52,62 @@ UAbilitySystemComponent* AAuraCharacterBase::GetAbilitySystemComponent() const
 	return AbilitySystemComponent;
 }
 
+void AAuraCharacterBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AAuraCharacterBase, DeathState);
+}
+
 UAnimMontage* AAuraCharacterBase::GetHitReactMontage_Implementation()
 {
 	return HitReactMontage;
 }
 
-void AAuraCharacterBase::Die()
+void AAuraCharacterBase::Die(const FVector& DeathImpulse)
 {
-	Weapon->DetachFromComponent(FDetachmentTransformRules(EDetachmentRule::KeepWorld, true));
-	MulticastHandleDeath();
+	if (DeathState.bDead) return;
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	DeathState.bDead = true;
+	DeathState.DeathImpulse = DeathImpulse;
+	DeathState.DeathTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	ForceNetUpdate();
+
+	HandleDeath();
 }
 
-void AAuraCharacterBase::MulticastHandleDeath_Implementation()
+void AAuraCharacterBase::OnRep_DeathState()
 {
-	UGameplayStatics::PlaySoundAtLocation(this, DeathSound, GetActorLocation(), GetActorRotation());
+	if (DeathState.bDead)
+	{
+		HandleDeath();
+	}
+}
+
+void AAuraCharacterBase::HandleDeath()
+{
+	if (bDead) return;
+	bDead = true;
+#if WITH_DEV_AUTOMATION_TESTS
+	++NumHandledDeaths;
+#endif
+
+	Weapon->DetachFromComponent(FDetachmentTransformRules(EDetachmentRule::KeepWorld, true));
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	if (UAuraVFXSubsystem* VFXSubsystem = GetWorld()->GetSubsystem<UAuraVFXSubsystem>())
+	{
+		VFXSubsystem->ClearDebuffVisuals(this);
+	}
+
+	// Ragdoll, sound and dissolve are purely cosmetic
+#if WITH_AURA_COSMETICS
+	if (GetNetMode() == NM_DedicatedServer) return;
+
+	// Significance may have slowed the meshes down, a ragdoll needs them every frame
+	Weapon->SetComponentTickInterval(0.f);
+	GetMesh()->SetComponentTickInterval(0.f);
 
 	Weapon->SetSimulatePhysics(true);
 	Weapon->SetEnableGravity(true);
@@ -62,18 +118,85 @@ void AAuraCharacterBase::MulticastHandleDeath_Implementation()
 	GetMesh()->SetCollisionEnabled(ECollisionEnabled::PhysicsOnly);
 	GetMesh()->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
 
+	if (UAuraCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UAuraCorpseSubsystem>())
+	{
+		CorpseSubsystem->RegisterCorpse(this);
+	}
 
-	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	Dissolve();
-	bDead = true;
-	BurnDebuffComponent->Deactivate();
+
+	// A client that only now became relevant gets the corpse, not the moment of death
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const float Now = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	if (Now - DeathState.DeathTime > CVarAuraDeathCosmeticWindow.GetValueOnGameThread()) return;
+
+	if (UAuraAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UAuraAudioSubsystem>())
+	{
+		AudioSubsystem->PlayCombatSound(DeathSound, GetActorLocation(), GetActorRotation());
+	}
+
+	if (!DeathState.DeathImpulse.IsNearlyZero())
+	{
+		GetMesh()->AddImpulse(DeathState.DeathImpulse, NAME_None, true);
+		Weapon->AddImpulse(DeathState.DeathImpulse * 0.1f, NAME_None, true);
+	}
+#endif
+}
+
+void AAuraCharacterBase::FinishDissolve()
+{
+	if (UAuraCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UAuraCorpseSubsystem>())
+	{
+		CorpseSubsystem->ReleaseCorpse(this);
+	}
 }
 
 // Called when the game starts or when spawned
 void AAuraCharacterBase::BeginPlay()
 {
+	// Before the components begin play, so the old component never listens for the tag itself
+	if (BurnDebuffComponent)
+	{
+		if (UNiagaraSystem* BurnEffect = BurnDebuffComponent->GetAsset())
+		{
+			DebuffEffects.FindOrAdd(FAuraGameplayTags::Get().Debuff_Burn, BurnEffect);
+		}
+		BurnDebuffComponent->DebuffTag = FGameplayTag();
+	}
+
 	Super::BeginPlay();
-	
+
+	if (AbilitySystemComponent)
+	{
+		RegisterDebuffEffects();
+	}
+	else
+	{
+		OnASCRegistered.AddWeakLambda(this, [this](UAbilitySystemComponent* InASC)
+		{
+			RegisterDebuffEffects();
+		});
+	}
+}
+
+void AAuraCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAuraVFXSubsystem* VFXSubsystem = GetWorld()->GetSubsystem<UAuraVFXSubsystem>())
+	{
+		VFXSubsystem->UnregisterDebuffVisuals(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AAuraCharacterBase::RegisterDebuffEffects()
+{
+	if (DebuffEffects.Num() == 0) return;
+
+	if (UAuraVFXSubsystem* VFXSubsystem = GetWorld()->GetSubsystem<UAuraVFXSubsystem>())
+	{
+		VFXSubsystem->RegisterDebuffVisuals(this, AbilitySystemComponent, DebuffEffects);
+	}
 }
 
 FVector AAuraCharacterBase::GetCombatSocketLocation_Implementation(const FGameplayTag& MontageTag)
@@ -188,6 +311,16 @@ void AAuraCharacterBase::AddCharacterAbilities()
 
 void AAuraCharacterBase::Dissolve()
 {
+#if WITH_AURA_COSMETICS
+	if (CVarAuraNativeDissolve.GetValueOnGameThread())
+	{
+		if (UAuraDissolveSubsystem* DissolveSubsystem = GetWorld()->GetSubsystem<UAuraDissolveSubsystem>())
+		{
+			DissolveSubsystem->StartDissolve(this);
+			return;
+		}
+	}
+
 	if (IsValid(DissolveMaterialInstance))
 	{
 		UMaterialInstanceDynamic* DynamicMatInst = UMaterialInstanceDynamic::Create(DissolveMaterialInstance, this);
@@ -200,5 +333,6 @@ void AAuraCharacterBase::Dissolve()
 		Weapon->SetMaterial(0, DynamicMatInst);
 		StartWeaponDissolveTimeline(DynamicMatInst);
 	}
+#endif
 }
 
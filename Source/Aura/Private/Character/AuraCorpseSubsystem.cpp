@@ -0,0 +1,161 @@
+// Copyright Adam Thomas
+
+
+#include "Character/AuraCorpseSubsystem.h"
+#include "Character/AuraCharacterBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Aura/AuraStats.h"
+#include "Aura/Aura.h"
+
+DECLARE_CYCLE_STAT(TEXT("Corpse Tick"), STAT_AuraCorpseTick, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Corpses"), STAT_AuraCorpses, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulating Ragdolls"), STAT_AuraSimulatingRagdolls, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulating Ragdoll Bodies"), STAT_AuraSimulatingRagdollBodies, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ragdolls Frozen"), STAT_AuraFrozenRagdolls, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Corpses Evicted"), STAT_AuraEvictedCorpses, STATGROUP_Aura);
+
+static TAutoConsoleVariable<int32> CVarAuraCorpseMaxSimulating(
+	TEXT("Aura.Corpse.MaxSimulating"),
+	8,
+	TEXT("Maximum number of ragdolls simulating at once, older ones are frozen in their current pose."));
+
+static TAutoConsoleVariable<int32> CVarAuraCorpseMaxCorpses(
+	TEXT("Aura.Corpse.MaxCorpses"),
+	32,
+	TEXT("Maximum number of corpses kept, older ones are hidden and their physics released."));
+
+static TAutoConsoleVariable<float> CVarAuraCorpseSettleTime(
+	TEXT("Aura.Corpse.SettleTime"),
+	3.f,
+	TEXT("Seconds after death a ragdoll is frozen even if the physics scene still has it awake."));
+
+void UAuraCorpseSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_AuraCorpseTick);
+
+	if (Corpses.Num() == 0) return;
+
+	const int32 MaxSimulating = CVarAuraCorpseMaxSimulating.GetValueOnGameThread();
+	const int32 MaxCorpses = CVarAuraCorpseMaxCorpses.GetValueOnGameThread();
+	const float SettleTime = CVarAuraCorpseSettleTime.GetValueOnGameThread();
+
+	Corpses.RemoveAll([](const FAuraCorpse& Corpse) { return !Corpse.Character.IsValid(); });
+
+	// Evict the oldest corpses beyond the budget
+	const int32 NumToEvict = Corpses.Num() - MaxCorpses;
+	for (int32 Index = 0; Index < NumToEvict; ++Index)
+	{
+		AAuraCharacterBase* Character = Corpses[Index].Character.Get();
+		ReleasePhysics(Character);
+		Character->SetActorHiddenInGame(true);
+		INC_DWORD_STAT(STAT_AuraEvictedCorpses);
+	}
+	if (NumToEvict > 0)
+	{
+		Corpses.RemoveAt(0, NumToEvict, false);
+	}
+
+	int32 NumSimulating = 0;
+	int32 NumSimulatingBodies = 0;
+	for (int32 Index = Corpses.Num() - 1; Index >= 0; --Index)
+	{
+		FAuraCorpse& Corpse = Corpses[Index];
+		if (!Corpse.bSimulating) continue;
+
+		Corpse.TimeSinceDeath += DeltaTime;
+
+		const USkeletalMeshComponent* Mesh = Corpse.Character->GetMesh();
+		const bool bSettled = Corpse.TimeSinceDeath >= SettleTime || !Mesh->RigidBodyIsAwake();
+
+		// Iterating newest first, so anything past the budget is one of the oldest
+		if (bSettled || NumSimulating >= MaxSimulating)
+		{
+			FreezeCorpse(Corpse);
+			continue;
+		}
+		++NumSimulating;
+		NumSimulatingBodies += Mesh->Bodies.Num();
+	}
+
+	SET_DWORD_STAT(STAT_AuraCorpses, Corpses.Num());
+	SET_DWORD_STAT(STAT_AuraSimulatingRagdolls, NumSimulating);
+	SET_DWORD_STAT(STAT_AuraSimulatingRagdollBodies, NumSimulatingBodies);
+}
+
+TStatId UAuraCorpseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraCorpseSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraCorpseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WITH_AURA_COSMETICS && (WorldType == EWorldType::Game || WorldType == EWorldType::PIE);
+}
+
+void UAuraCorpseSubsystem::RegisterCorpse(AAuraCharacterBase* Character)
+{
+	if (!IsValid(Character)) return;
+
+	FAuraCorpse& Corpse = Corpses.AddDefaulted_GetRef();
+	Corpse.Character = Character;
+}
+
+void UAuraCorpseSubsystem::ReleaseCorpse(AAuraCharacterBase* Character)
+{
+	const int32 Index = Corpses.IndexOfByPredicate([Character](const FAuraCorpse& Corpse) { return Corpse.Character == Character; });
+	if (Index == INDEX_NONE) return;
+
+	ReleasePhysics(Character);
+	Corpses.RemoveAt(Index, 1, false);
+}
+
+int32 UAuraCorpseSubsystem::GetNumSimulatingCorpses() const
+{
+	int32 NumSimulating = 0;
+	for (const FAuraCorpse& Corpse : Corpses)
+	{
+		NumSimulating += Corpse.bSimulating ? 1 : 0;
+	}
+	return NumSimulating;
+}
+
+bool UAuraCorpseSubsystem::IsCorpse(const AAuraCharacterBase* Character) const
+{
+	return Corpses.ContainsByPredicate([Character](const FAuraCorpse& Corpse) { return Corpse.Character == Character; });
+}
+
+void UAuraCorpseSubsystem::FreezeCorpse(FAuraCorpse& Corpse)
+{
+	FreezeMesh(Corpse.Character->GetMesh());
+	FreezeMesh(Corpse.Character->GetWeapon());
+	Corpse.bSimulating = false;
+	INC_DWORD_STAT(STAT_AuraFrozenRagdolls);
+}
+
+void UAuraCorpseSubsystem::FreezeMesh(USkeletalMeshComponent* Mesh)
+{
+	if (Mesh == nullptr) return;
+
+	// Skipping skeleton updates keeps the last simulated bone transforms once the bodies stop simulating,
+	// sleeping alone would leave them in the scene where any contact wakes them past the budget
+	Mesh->bNoSkeletonUpdate = true;
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Mesh->SetComponentTickEnabled(false);
+}
+
+void UAuraCorpseSubsystem::ReleasePhysics(AAuraCharacterBase* Character)
+{
+	if (!IsValid(Character)) return;
+
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	if (USkeletalMeshComponent* Weapon = Character->GetWeapon())
+	{
+		Weapon->SetSimulatePhysics(false);
+		Weapon->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+}
@@ -0,0 +1,198 @@
+// Copyright Adam Thomas
+
+
+#include "Character/AuraDissolveSubsystem.h"
+#include "Character/AuraCharacterBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Aura/AuraStats.h"
+#include "Aura/Aura.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dissolve Tick"), STAT_AuraDissolveTick, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Dissolves"), STAT_AuraActiveDissolves, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Live Dissolve MIDs"), STAT_AuraLiveDissolveMIDs, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Dissolve MIDs"), STAT_AuraPooledDissolveMIDs, STATGROUP_Aura);
+
+static TAutoConsoleVariable<int32> CVarAuraDissolveMaxMIDs(
+	TEXT("Aura.Dissolve.MaxMIDs"),
+	32,
+	TEXT("Upper bound on pooled dissolve material instances. Dissolves that need one while the pool is exhausted wait for an instance to be returned, characters using custom primitive data need none."));
+
+void UAuraDissolveSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_AuraDissolveTick);
+
+	for (int32 Index = ActiveDissolves.Num() - 1; Index >= 0; --Index)
+	{
+		FAuraDissolve& Dissolve = ActiveDissolves[Index];
+		if (!IsValid(Dissolve.Character))
+		{
+			ReleaseMID(Dissolve.MeshMID, nullptr);
+			ReleaseMID(Dissolve.WeaponMID, nullptr);
+			ActiveDissolves.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const AAuraCharacterBase* Character = Dissolve.Character;
+		Dissolve.Elapsed += DeltaTime;
+		const float Alpha = Character->DissolveDuration > 0.f ? FMath::Min(Dissolve.Elapsed / Character->DissolveDuration, 1.f) : 1.f;
+		ApplyDissolveValue(Dissolve, Character->DissolveParameterName, FMath::Lerp(Character->DissolveStartValue, Character->DissolveEndValue, Alpha));
+
+		if (Alpha >= 1.f)
+		{
+			FinishDissolve(Dissolve);
+			ActiveDissolves.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	// Finished dissolves have returned their instances, start as many of the waiting ones as they allow, oldest first.
+	// If nothing is dissolving nothing will be returned either, so the oldest goes over budget rather than waiting forever
+	while (PendingDissolves.Num() > 0)
+	{
+		AAuraCharacterBase* Character = PendingDissolves[0];
+		if (IsValid(Character) && !TryStartDissolve(Character, ActiveDissolves.Num() == 0)) break;
+		PendingDissolves.RemoveAt(0, 1, false);
+	}
+
+	SET_DWORD_STAT(STAT_AuraActiveDissolves, ActiveDissolves.Num());
+	SET_DWORD_STAT(STAT_AuraLiveDissolveMIDs, GetNumLiveMIDs());
+	SET_DWORD_STAT(STAT_AuraPooledDissolveMIDs, FreeMIDs.Num());
+}
+
+TStatId UAuraDissolveSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraDissolveSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraDissolveSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WITH_AURA_COSMETICS && (WorldType == EWorldType::Game || WorldType == EWorldType::PIE);
+}
+
+void UAuraDissolveSubsystem::StartDissolve(AAuraCharacterBase* Character)
+{
+	if (!IsValid(Character)) return;
+
+	if (PendingDissolves.Num() > 0 || !TryStartDissolve(Character, false))
+	{
+		PendingDissolves.Add(Character);
+	}
+}
+
+bool UAuraDissolveSubsystem::TryStartDissolve(AAuraCharacterBase* Character, bool bIgnoreBudget)
+{
+	USkeletalMeshComponent* Weapon = Character->GetWeapon();
+	UMaterialInstanceDynamic* MeshMID = nullptr;
+	UMaterialInstanceDynamic* WeaponMID = nullptr;
+
+	// Without custom primitive data the material can only be driven through a MID, so the dissolve waits for one
+	if (!Character->bDissolveUsesCustomPrimitiveData)
+	{
+		if (IsValid(Character->DissolveMaterialInstance))
+		{
+			MeshMID = AcquireMID(Character->DissolveMaterialInstance, bIgnoreBudget);
+			if (MeshMID == nullptr) return false;
+		}
+		if (IsValid(Character->WeaponDissolveMaterialInstance) && Weapon)
+		{
+			WeaponMID = AcquireMID(Character->WeaponDissolveMaterialInstance, bIgnoreBudget);
+			if (WeaponMID == nullptr)
+			{
+				ReleaseMID(MeshMID, nullptr);
+				return false;
+			}
+		}
+	}
+
+	FAuraDissolve& Dissolve = ActiveDissolves.AddDefaulted_GetRef();
+	Dissolve.Character = Character;
+	Dissolve.Mesh = Character->GetMesh();
+	Dissolve.Weapon = Weapon;
+	Dissolve.MeshMID = MeshMID;
+	Dissolve.WeaponMID = WeaponMID;
+
+	if (IsValid(Character->DissolveMaterialInstance))
+	{
+		Dissolve.Mesh->SetMaterial(0, MeshMID ? MeshMID : static_cast<UMaterialInterface*>(Character->DissolveMaterialInstance));
+	}
+	if (IsValid(Character->WeaponDissolveMaterialInstance) && Weapon)
+	{
+		Weapon->SetMaterial(0, WeaponMID ? WeaponMID : static_cast<UMaterialInterface*>(Character->WeaponDissolveMaterialInstance));
+	}
+
+	ApplyDissolveValue(Dissolve, Character->DissolveParameterName, Character->DissolveStartValue);
+	return true;
+}
+
+void UAuraDissolveSubsystem::ApplyDissolveValue(const FAuraDissolve& Dissolve, FName ParameterName, float Value)
+{
+	if (Dissolve.MeshMID)
+	{
+		Dissolve.MeshMID->SetScalarParameterValue(ParameterName, Value);
+	}
+	else if (Dissolve.Mesh)
+	{
+		Dissolve.Mesh->SetScalarParameterForCustomPrimitiveData(ParameterName, Value);
+	}
+
+	if (Dissolve.WeaponMID)
+	{
+		Dissolve.WeaponMID->SetScalarParameterValue(ParameterName, Value);
+	}
+	else if (Dissolve.Weapon)
+	{
+		Dissolve.Weapon->SetScalarParameterForCustomPrimitiveData(ParameterName, Value);
+	}
+}
+
+void UAuraDissolveSubsystem::FinishDissolve(FAuraDissolve& Dissolve)
+{
+	// Fully dissolved, so hiding is invisible and lets the instances go back to the pool
+	if (Dissolve.Mesh) Dissolve.Mesh->SetVisibility(false);
+	if (Dissolve.Weapon) Dissolve.Weapon->SetVisibility(false);
+
+	ReleaseMID(Dissolve.MeshMID, Dissolve.Mesh);
+	ReleaseMID(Dissolve.WeaponMID, Dissolve.Weapon);
+	Dissolve.MeshMID = nullptr;
+	Dissolve.WeaponMID = nullptr;
+
+	Dissolve.Character->FinishDissolve();
+}
+
+UMaterialInstanceDynamic* UAuraDissolveSubsystem::AcquireMID(UMaterialInterface* ParentMaterial, bool bIgnoreBudget)
+{
+	const int32 FreeIndex = FreeMIDs.IndexOfByPredicate([ParentMaterial](const UMaterialInstanceDynamic* MID) { return MID->Parent == ParentMaterial; });
+	if (FreeIndex != INDEX_NONE)
+	{
+		UMaterialInstanceDynamic* MID = FreeMIDs[FreeIndex];
+		FreeMIDs.RemoveAtSwap(FreeIndex, 1, false);
+		return MID;
+	}
+
+	if (NumMIDs >= CVarAuraDissolveMaxMIDs.GetValueOnGameThread() && FreeMIDs.Num() > 0)
+	{
+		// Make room by dropping an idle instance of another material
+		FreeMIDs.Pop(false);
+		--NumMIDs;
+	}
+	else if (NumMIDs >= CVarAuraDissolveMaxMIDs.GetValueOnGameThread() && !bIgnoreBudget)
+	{
+		return nullptr;
+	}
+
+	++NumMIDs;
+	return UMaterialInstanceDynamic::Create(ParentMaterial, this);
+}
+
+void UAuraDissolveSubsystem::ReleaseMID(UMaterialInstanceDynamic* MID, UMeshComponent* MeshComponent)
+{
+	if (MID == nullptr) return;
+
+	if (IsValid(MeshComponent))
+	{
+		MeshComponent->SetMaterial(0, MID->Parent);
+	}
+	MID->ClearParameterValues();
+	FreeMIDs.Add(MID);
+}
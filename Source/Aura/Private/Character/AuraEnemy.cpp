@@ -11,7 +11,11 @@
 #include "AI/AuraAIController.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "BrainComponent.h"
+#include "Game/AuraVFXSubsystem.h"
+#include "UI/HUD/AuraHealthBarSubsystem.h"
 
 #include "Aura/Aura.h"
 
@@ -32,8 +36,10 @@ AAuraEnemy::AAuraEnemy()
 
 	AttributeSet = CreateDefaultSubobject<UAuraAttributeSet>("AttributeSet");
 
+#if WITH_AURA_COSMETICS
 	HealthBar = CreateDefaultSubobject<UWidgetComponent>("HealthBar");
 	HealthBar->SetupAttachment(GetRootComponent());
+#endif
 }
 
 void AAuraEnemy::PossessedBy(AController* NewController)
@@ -46,7 +52,10 @@ void AAuraEnemy::PossessedBy(AController* NewController)
 	AuraAIController->GetBlackboardComponent()->InitializeBlackboard(*BehaviorTree->BlackboardAsset);
 	AuraAIController->RunBehaviorTree(BehaviorTree);
 
-	AuraAIController->GetBlackboardComponent()->SetValueAsBool(FName("HitReacting"), false);
+	HitReactingKey = AuraAIController->GetBlackboardComponent()->GetKeyID(FName("HitReacting"));
+	DeadKey = AuraAIController->GetBlackboardComponent()->GetKeyID(FName("Dead"));
+
+	AuraAIController->GetBlackboardComponent()->SetValue<UBlackboardKeyType_Bool>(HitReactingKey, false);
 	AuraAIController->GetBlackboardComponent()->SetValueAsBool(FName("RangedAttacker"), CharacterClass != ECharacterClass::Warrior);
 }
 
@@ -69,11 +78,11 @@ int32 AAuraEnemy::GetPlayerLevel_Implementation()
 	return Level;
 }
 
-void AAuraEnemy::Die()
+void AAuraEnemy::Die(const FVector& DeathImpulse)
 {
 	SetLifeSpan(LifeSpan);
-	if(AuraAIController) AuraAIController->GetBlackboardComponent()->SetValueAsBool(FName("Dead"), true);
-	Super::Die();
+	if(AuraAIController) AuraAIController->GetBlackboardComponent()->SetValue<UBlackboardKeyType_Bool>(DeadKey, true);
+	Super::Die(DeathImpulse);
 }
 
 void AAuraEnemy::SetCombatTarget_Implementation(AActor* InCombatTarget)
@@ -93,11 +102,56 @@ void AAuraEnemy::BeginPlay()
 
 	InitAbilityActorInfo();
 
-	if (HasAuthority())
+	if (UAuraSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UAuraSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->RegisterEnemy(this);
+	}
+
+	if (HasAuthority() && !bDeferStartupInitialisation)
 	{
 		UAuraAbilitySystemLibrary::GiveStartupAbilities(this, AbilitySystemComponent, CharacterClass);
 	}
 
+	AbilitySystemComponent->RegisterGameplayTagEvent(FAuraGameplayTags::Get().Effects_HitReact, EGameplayTagEventType::NewOrRemoved).AddUObject(
+		this, 
+		&AAuraEnemy::HitReactTagChanged
+	);
+
+#if WITH_AURA_COSMETICS
+	if (GetNetMode() == NM_DedicatedServer) return;
+
+	if (!bUseWidgetHealthBar)
+	{
+		if (HealthBar)
+		{
+			HealthBar->DestroyComponent();
+			HealthBar = nullptr;
+		}
+
+		if (UAuraAttributeSet* AuraAS = Cast<UAuraAttributeSet>(AttributeSet))
+		{
+			if (UAuraHealthBarSubsystem* HealthBarSubsystem = GetWorld()->GetSubsystem<UAuraHealthBarSubsystem>())
+			{
+				HealthBarSubsystem->Register(this, HealthBarHeightOffset, AuraAS->GetHealth(), AuraAS->GetMaxHealth());
+
+				AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AuraAS->GetHealthAttribute()).AddWeakLambda(HealthBarSubsystem,
+					[this, HealthBarSubsystem](const FOnAttributeChangeData& Data)
+					{
+						HealthBarSubsystem->SetHealth(this, Data.NewValue);
+					}
+				);
+
+				AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AuraAS->GetMaxHealthAttribute()).AddWeakLambda(HealthBarSubsystem,
+					[this, HealthBarSubsystem](const FOnAttributeChangeData& Data)
+					{
+						HealthBarSubsystem->SetMaxHealth(this, Data.NewValue);
+					}
+				);
+			}
+		}
+		return;
+	}
+
 	/*
 	Step 1: Check if the UserWidget is valid, casting the WidgetComponent to AuraUserWidget and 
 	get object, if valid, set widgetcontroller, using the hint from video, I'll set it to Enemy Class (this)
@@ -127,14 +181,47 @@ void AAuraEnemy::BeginPlay()
 			}
 		);
 
-		AbilitySystemComponent->RegisterGameplayTagEvent(FAuraGameplayTags::Get().Effects_HitReact, EGameplayTagEventType::NewOrRemoved).AddUObject(
-			this, 
-			&AAuraEnemy::HitReactTagChanged
-		);
-
 		OnHealthChanged.Broadcast(AuraAS->GetHealth());
 		OnMaxHealthChanged.Broadcast(AuraAS->GetMaxHealth());
 	}
+#endif
+}
+
+void AAuraEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAuraHealthBarSubsystem* HealthBarSubsystem = GetWorld()->GetSubsystem<UAuraHealthBarSubsystem>())
+	{
+		HealthBarSubsystem->Unregister(this);
+	}
+	if (UAuraSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UAuraSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->UnregisterEnemy(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void AAuraEnemy::SetSignificance(EAuraSignificance NewSignificance)
+{
+	if (Significance == NewSignificance) return;
+	Significance = NewSignificance;
+
+	const float TickInterval = UAuraSignificanceSubsystem::GetTickInterval(Significance);
+	GetCharacterMovement()->SetComponentTickInterval(TickInterval);
+	// Ragdolls are blended from physics in the mesh tick, so a simulating corpse keeps ticking every frame
+	const float MeshTickInterval = bDead ? 0.f : TickInterval;
+	GetMesh()->SetComponentTickInterval(MeshTickInterval);
+	Weapon->SetComponentTickInterval(MeshTickInterval);
+	if (HealthBar) HealthBar->SetComponentTickInterval(TickInterval);
+
+	if (AuraAIController && AuraAIController->GetBrainComponent())
+	{
+		AuraAIController->GetBrainComponent()->SetComponentTickInterval(TickInterval);
+	}
+
+	if (UAuraVFXSubsystem* VFXSubsystem = GetWorld()->GetSubsystem<UAuraVFXSubsystem>())
+	{
+		VFXSubsystem->SetDebuffVisualsSuppressed(this, Significance == EAuraSignificance::Low);
+	}
 }
 
 void AAuraEnemy::HitReactTagChanged(const FGameplayTag CallbackTag, int32 NewCount)
@@ -144,7 +231,7 @@ void AAuraEnemy::HitReactTagChanged(const FGameplayTag CallbackTag, int32 NewCou
 
 	if(AuraAIController && AuraAIController->GetBlackboardComponent())
 	{
-		AuraAIController->GetBlackboardComponent()->SetValueAsBool(FName("HitReacting"), bHitReacting);
+		AuraAIController->GetBlackboardComponent()->SetValue<UBlackboardKeyType_Bool>(HitReactingKey, bHitReacting);
 	}
 }
 
@@ -152,13 +239,25 @@ void AAuraEnemy::InitAbilityActorInfo()
 {
 	AbilitySystemComponent->InitAbilityActorInfo(this, this);
 	Cast<UAuraAbilitySystemComponent>(AbilitySystemComponent)->AbilityActorInfoSet();
-	if(HasAuthority())
+	if(HasAuthority() && !bDeferStartupInitialisation)
 	{
 		InitialiseDefaultAttributes();
 	}
 	OnASCRegistered.Broadcast(AbilitySystemComponent);
 }
 
+void AAuraEnemy::FinishStartupInitialisation()
+{
+	if (!bDeferStartupInitialisation) return;
+	bDeferStartupInitialisation = false;
+
+	if (HasAuthority())
+	{
+		InitialiseDefaultAttributes();
+		UAuraAbilitySystemLibrary::GiveStartupAbilities(this, AbilitySystemComponent, CharacterClass);
+	}
+}
+
 void AAuraEnemy::InitialiseDefaultAttributes() const
 {
 	UAuraAbilitySystemLibrary::InitializeDefaultAttributes(this, CharacterClass, Level, AbilitySystemComponent);
@@ -0,0 +1,144 @@
+// Copyright Adam Thomas
+
+
+#include "Character/AuraSignificanceSubsystem.h"
+#include "Character/AuraEnemy.h"
+#include "DrawDebugHelpers.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<float> CVarAuraSignificanceUpdateInterval(
+	TEXT("Aura.Significance.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between enemy significance updates."));
+
+static TAutoConsoleVariable<float> CVarAuraSignificanceHighDistance(
+	TEXT("Aura.Significance.HighDistance"),
+	1500.f,
+	TEXT("Enemies closer than this to a player are fully significant."));
+
+static TAutoConsoleVariable<float> CVarAuraSignificanceMediumDistance(
+	TEXT("Aura.Significance.MediumDistance"),
+	4000.f,
+	TEXT("Enemies closer than this to a player are of medium significance, anything further is low."));
+
+static TAutoConsoleVariable<float> CVarAuraSignificanceMediumTickInterval(
+	TEXT("Aura.Significance.MediumTickInterval"),
+	0.05f,
+	TEXT("Component tick interval for medium significance enemies."));
+
+static TAutoConsoleVariable<float> CVarAuraSignificanceLowTickInterval(
+	TEXT("Aura.Significance.LowTickInterval"),
+	0.2f,
+	TEXT("Component tick interval for low significance enemies."));
+
+static TAutoConsoleVariable<bool> CVarAuraSignificanceDebug(
+	TEXT("Aura.Significance.Debug"),
+	false,
+	TEXT("Draw the significance bucket of every enemy."));
+
+void UAuraSignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	const float UpdateInterval = CVarAuraSignificanceUpdateInterval.GetValueOnGameThread();
+	if (TimeSinceUpdate < UpdateInterval || Enemies.Num() == 0) return;
+	TimeSinceUpdate = 0.f;
+
+	TArray<FVector, TInlineAllocator<4>> ViewerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr)
+		{
+			ViewerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	// Servers tick AI for every player, so only clients and standalone games let local rendering demote an enemy
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	const bool bCanUseVisibility = NetMode == NM_Client || NetMode == NM_Standalone;
+	const bool bDrawDebug = CVarAuraSignificanceDebug.GetValueOnGameThread();
+
+	for (int32 Index = Enemies.Num() - 1; Index >= 0; --Index)
+	{
+		AAuraEnemy* Enemy = Enemies[Index].Get();
+		if (Enemy == nullptr)
+		{
+			Enemies.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const EAuraSignificance Significance = ScoreEnemy(Enemy, ViewerLocations, bCanUseVisibility);
+		Enemy->SetSignificance(Significance);
+
+#if ENABLE_DRAW_DEBUG
+		if (bDrawDebug)
+		{
+			const FColor Color = Significance == EAuraSignificance::High ? FColor::Green : Significance == EAuraSignificance::Medium ? FColor::Yellow : FColor::Red;
+			DrawDebugString(GetWorld(), Enemy->GetActorLocation() + FVector(0.f, 0.f, 120.f), UEnum::GetDisplayValueAsText(Significance).ToString(), nullptr, Color, UpdateInterval);
+			DrawDebugSphere(GetWorld(), Enemy->GetActorLocation(), 50.f, 8, Color, false, UpdateInterval);
+		}
+#endif
+	}
+}
+
+TStatId UAuraSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraSignificanceSubsystem::RegisterEnemy(AAuraEnemy* Enemy)
+{
+	Enemies.AddUnique(Enemy);
+}
+
+void UAuraSignificanceSubsystem::UnregisterEnemy(AAuraEnemy* Enemy)
+{
+	Enemies.RemoveSwap(Enemy, false);
+}
+
+float UAuraSignificanceSubsystem::GetTickInterval(EAuraSignificance Significance)
+{
+	switch (Significance)
+	{
+	case EAuraSignificance::Medium:
+		return CVarAuraSignificanceMediumTickInterval.GetValueOnGameThread();
+	case EAuraSignificance::Low:
+		return CVarAuraSignificanceLowTickInterval.GetValueOnGameThread();
+	default:
+		return 0.f;
+	}
+}
+
+EAuraSignificance UAuraSignificanceSubsystem::ScoreEnemy(const AAuraEnemy* Enemy, const TArray<FVector, TInlineAllocator<4>>& ViewerLocations, bool bCanUseVisibility) const
+{
+	if (Enemy->IsDead_Implementation()) return EAuraSignificance::Low;
+
+	float MinDistanceSquared = TNumericLimits<float>::Max();
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ViewerLocation, Enemy->GetActorLocation()));
+	}
+
+	EAuraSignificance Significance = EAuraSignificance::Low;
+	if (MinDistanceSquared <= FMath::Square(CVarAuraSignificanceHighDistance.GetValueOnGameThread()))
+	{
+		Significance = EAuraSignificance::High;
+	}
+	else if (MinDistanceSquared <= FMath::Square(CVarAuraSignificanceMediumDistance.GetValueOnGameThread()))
+	{
+		Significance = EAuraSignificance::Medium;
+	}
+
+	// Off screen enemies drop one bucket
+	if (bCanUseVisibility && Significance != EAuraSignificance::Low && !Enemy->WasRecentlyRendered(0.5f))
+	{
+		Significance = static_cast<EAuraSignificance>(static_cast<uint8>(Significance) + 1);
+	}
+	return Significance;
+}
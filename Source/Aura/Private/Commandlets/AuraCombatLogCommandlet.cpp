@@ -0,0 +1,261 @@
+// Copyright Adam Thomas
+
+
+#include "Commandlets/AuraCombatLogCommandlet.h"
+#include "Game/AuraCombatLog.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "AbilitySystem/AuraRandomStream.h"
+#include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "GameplayTagsManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Aura/AuraLogChannels.h"
+
+namespace AuraCombatLogCommandlet
+{
+	struct FHitTotals
+	{
+		int64 Hits = 0;
+		int64 BlockedHits = 0;
+		int64 CriticalHits = 0;
+		double Damage = 0.0;
+		float MaxDamage = 0.f;
+
+		void Add(const FAuraCombatLogRecord& Record)
+		{
+			++Hits;
+			if (EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::BlockedHit)) ++BlockedHits;
+			if (EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::CriticalHit)) ++CriticalHits;
+			Damage += Record.Value;
+			MaxDamage = FMath::Max(MaxDamage, Record.Value);
+		}
+
+		void Log(const FString& Label) const
+		{
+			if (Hits == 0) return;
+			UE_LOG(LogAura, Display, TEXT("%-24s %10lld %12.2f %10.2f %8.1f%% %8.1f%%"), *Label, Hits, Damage / Hits, MaxDamage,
+				100.0 * BlockedHits / Hits, 100.0 * CriticalHits / Hits);
+		}
+	};
+
+	static FString GetDamageTypeName(uint16 NetIndex)
+	{
+		if (NetIndex == 0) return TEXT("None");
+		const FName& TagName = UGameplayTagsManager::Get().GetTagNameFromNetIndex(NetIndex);
+		return TagName.IsNone() ? FString::Printf(TEXT("#%u"), NetIndex) : TagName.ToString();
+	}
+
+	static FString GetClassName(uint8 CharacterClass)
+	{
+		return StaticEnum<ECharacterClass>()->GetNameStringByValue(CharacterClass);
+	}
+}
+
+UAuraCombatLogCommandlet::UAuraCombatLogCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UAuraCombatLogCommandlet::Main(const FString& Params)
+{
+	using namespace AuraCombatLogCommandlet;
+
+	FString LogPath = FPaths::ProjectSavedDir() / TEXT("CombatLogs");
+	FParse::Value(*Params, TEXT("Log="), LogPath);
+
+	FString TypeFilter;
+	FParse::Value(*Params, TEXT("Type="), TypeFilter);
+
+	uint32 SourceFilter = 0;
+	FParse::Value(*Params, TEXT("Source="), SourceFilter);
+
+	uint32 TargetFilter = 0;
+	FParse::Value(*Params, TEXT("Target="), TargetFilter);
+
+	FString DamageTypeFilter;
+	FParse::Value(*Params, TEXT("DamageType="), DamageTypeFilter);
+
+	double FromTime = -DBL_MAX;
+	FParse::Value(*Params, TEXT("From="), FromTime);
+
+	double ToTime = DBL_MAX;
+	FParse::Value(*Params, TEXT("To="), ToTime);
+
+	FString CsvPath;
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	const bool bReplay = FParse::Param(*Params, TEXT("Replay"));
+
+	float Tolerance = 0.01f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	TArray<FString> Filenames;
+	if (IFileManager::Get().DirectoryExists(*LogPath))
+	{
+		IFileManager::Get().FindFiles(Filenames, *(LogPath / TEXT("*.auralog")), true, false);
+		for (FString& Filename : Filenames)
+		{
+			Filename = LogPath / Filename;
+		}
+		Filenames.Sort();
+	}
+	else if (FPaths::FileExists(LogPath))
+	{
+		Filenames.Add(LogPath);
+	}
+
+	if (Filenames.Num() == 0)
+	{
+		UE_LOG(LogAura, Error, TEXT("No combat logs found at %s"), *LogPath);
+		return 1;
+	}
+
+	uint16 DamageTypeIndex = 0;
+	if (!DamageTypeFilter.IsEmpty())
+	{
+		const FGameplayTag DamageType = FGameplayTag::RequestGameplayTag(FName(*DamageTypeFilter), false);
+		if (!DamageType.IsValid())
+		{
+			UE_LOG(LogAura, Error, TEXT("%s is not a gameplay tag"), *DamageTypeFilter);
+			return 1;
+		}
+		DamageTypeIndex = UGameplayTagsManager::Get().GetNetIndexFromTag(DamageType);
+	}
+
+	TArray<FString> CsvLines;
+	if (!CsvPath.IsEmpty())
+	{
+		CsvLines.Add(TEXT("File,Time,Type,SourceId,TargetId,SourceClass,SourceLevel,TargetClass,TargetLevel,DamageType,Value,Blocked,Critical,Debuff,RollSeed"));
+	}
+
+	int64 Counts[static_cast<int32>(EAuraCombatLogRecordType::LevelUp) + 1] = {};
+	FHitTotals AllHits;
+	TMap<FString, FHitTotals> HitsByDamageType;
+	TMap<FString, FHitTotals> HitsByMatchup;
+	int64 Replayed = 0;
+	int64 Mismatches = 0;
+	float MaxReplayError = 0.f;
+	int32 Errors = 0;
+
+	for (const FString& Filename : Filenames)
+	{
+		FAuraCombatLog Log;
+		if (!Log.Load(Filename))
+		{
+			UE_LOG(LogAura, Error, TEXT("%s is not a combat log of version %u"), *Filename, FAuraCombatLog::Version);
+			++Errors;
+			continue;
+		}
+
+		const FString ShortFilename = FPaths::GetCleanFilename(Filename);
+		UE_LOG(LogAura, Display, TEXT("%s: %d records, started %s"), *ShortFilename, Log.GetRecords().Num(), *Log.GetStartTime().ToString());
+
+		for (const FAuraCombatLogRecord& Record : Log.GetRecords())
+		{
+			if (!TypeFilter.IsEmpty() && TypeFilter != FAuraCombatLog::LexToString(Record.Type)) continue;
+			if (SourceFilter != 0 && Record.SourceId != SourceFilter) continue;
+			if (TargetFilter != 0 && Record.TargetId != TargetFilter) continue;
+			if (DamageTypeIndex != 0 && Record.DamageType != DamageTypeIndex) continue;
+			if (Record.Time < FromTime || Record.Time > ToTime) continue;
+
+			if (static_cast<int32>(Record.Type) < UE_ARRAY_COUNT(Counts))
+			{
+				++Counts[static_cast<int32>(Record.Type)];
+			}
+
+			if (Record.Type == EAuraCombatLogRecordType::Hit)
+			{
+				AllHits.Add(Record);
+				HitsByDamageType.FindOrAdd(GetDamageTypeName(Record.DamageType)).Add(Record);
+				HitsByMatchup.FindOrAdd(GetClassName(Record.SourceClass) + TEXT(" > ") + GetClassName(Record.TargetClass)).Add(Record);
+
+				if (bReplay)
+				{
+					++Replayed;
+					bool bRollsMatch = true;
+					const float ReplayedDamage = ReplayHit(Record, bRollsMatch);
+					const float Error = FMath::Abs(ReplayedDamage - Record.Value);
+					MaxReplayError = FMath::Max(MaxReplayError, Error);
+					if (Error > Tolerance || !bRollsMatch)
+					{
+						if (Mismatches++ < 20)
+						{
+							UE_LOG(LogAura, Warning, TEXT("%s %.3f: hit %u > %u recorded %.3f, kernel gives %.3f%s (seed %llu)"), *ShortFilename, Record.Time,
+								Record.SourceId, Record.TargetId, Record.Value, ReplayedDamage, bRollsMatch ? TEXT("") : TEXT(", block or crit rolled differently"), Record.RollSeed);
+						}
+					}
+				}
+			}
+
+			if (!CsvPath.IsEmpty())
+			{
+				CsvLines.Add(FString::Printf(TEXT("%s,%.4f,%s,%u,%u,%s,%u,%s,%u,%s,%f,%d,%d,%d,%llu"), *ShortFilename, Record.Time, FAuraCombatLog::LexToString(Record.Type),
+					Record.SourceId, Record.TargetId, *GetClassName(Record.SourceClass), Record.SourceLevel, *GetClassName(Record.TargetClass), Record.TargetLevel,
+					*GetDamageTypeName(Record.DamageType), Record.Value,
+					EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::BlockedHit) ? 1 : 0,
+					EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::CriticalHit) ? 1 : 0,
+					EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::SuccessfulDebuff) ? 1 : 0,
+					Record.RollSeed));
+			}
+		}
+	}
+
+	for (int32 Type = 0; Type < UE_ARRAY_COUNT(Counts); ++Type)
+	{
+		UE_LOG(LogAura, Display, TEXT("%-10s %lld"), FAuraCombatLog::LexToString(static_cast<EAuraCombatLogRecordType>(Type)), Counts[Type]);
+	}
+
+	if (AllHits.Hits > 0)
+	{
+		UE_LOG(LogAura, Display, TEXT("%-24s %10s %12s %10s %9s %9s"), TEXT(""), TEXT("Hits"), TEXT("Damage/Hit"), TEXT("Max"), TEXT("Blocked"), TEXT("Critical"));
+		AllHits.Log(TEXT("All"));
+		for (const TPair<FString, FHitTotals>& Pair : HitsByDamageType)
+		{
+			Pair.Value.Log(Pair.Key);
+		}
+		for (const TPair<FString, FHitTotals>& Pair : HitsByMatchup)
+		{
+			Pair.Value.Log(Pair.Key);
+		}
+	}
+
+	if (bReplay)
+	{
+		UE_LOG(LogAura, Display, TEXT("Replayed %lld hits, %lld differ by more than %.3f, largest difference %.4f"), Replayed, Mismatches, Tolerance, MaxReplayError);
+	}
+
+	if (!CsvPath.IsEmpty())
+	{
+		if (FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath))
+		{
+			UE_LOG(LogAura, Display, TEXT("Wrote %d records to %s"), CsvLines.Num() - 1, *CsvPath);
+		}
+		else
+		{
+			UE_LOG(LogAura, Error, TEXT("Could not write %s"), *CsvPath);
+			++Errors;
+		}
+	}
+
+	return Errors > 0 || Mismatches > 0 ? 1 : 0;
+}
+
+float UAuraCombatLogCommandlet::ReplayHit(const FAuraCombatLogRecord& Record, bool& bOutRollsMatch)
+{
+	const FAuraCombatLogHit& Hit = Record.Hit;
+
+	// Same draws in the same order as UExecCalc_Damage
+	FAuraRandomStream RollStream(Record.RollSeed);
+	const bool bBlocked = RollStream.RandRange(1, 100) < Hit.TargetBlockChance;
+	const bool bCriticalHit = RollStream.RandRange(1, 100) < Hit.EffectiveCriticalHitChance;
+	bOutRollsMatch = bBlocked == EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::BlockedHit)
+		&& bCriticalHit == EnumHasAnyFlags(Record.Flags, EAuraCombatLogFlags::CriticalHit);
+
+	float Damage = FAuraDamageKernel::ApplyBlock(Hit.Damage, bBlocked);
+	Damage = FAuraDamageKernel::ApplyArmour(Damage, Hit.TargetArmour, Hit.SourceArmourPenetration, Hit.ArmourPenetrationCoefficient, Hit.EffectiveArmourCoefficient);
+	return FAuraDamageKernel::ApplyCriticalHit(Damage, bCriticalHit, Hit.SourceCriticalHitDamage);
+}
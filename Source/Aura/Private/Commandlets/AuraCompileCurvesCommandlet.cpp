@@ -0,0 +1,171 @@
+// Copyright Adam Thomas
+
+
+#include "Commandlets/AuraCompileCurvesCommandlet.h"
+#include "AbilitySystem/Data/AuraCompiledCurveTable.h"
+#include "Engine/CurveTable.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Aura/AuraLogChannels.h"
+
+UAuraCompileCurvesCommandlet::UAuraCompileCurvesCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UAuraCompileCurvesCommandlet::Main(const FString& Params)
+{
+	FString SourceDirectory = FPaths::ProjectDir() / TEXT("Data");
+	FParse::Value(*Params, TEXT("Source="), SourceDirectory);
+
+	FString TablePaths;
+	FParse::Value(*Params, TEXT("Tables="), TablePaths, false);
+
+	int32 MaxLevel = 0;
+	FParse::Value(*Params, TEXT("MaxLevel="), MaxLevel);
+
+	const bool bValidateOnly = FParse::Param(*Params, TEXT("ValidateOnly"));
+
+	TArray<FString> Errors;
+	// Compiled bytes per asset package, sources of the same table in several formats must agree
+	TMap<FString, TArray<uint8>> Compiled;
+
+	// Curve table assets by name, every source is checked against the asset the game evaluates
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+	TArray<FAssetData> CurveTableAssets;
+	AssetRegistry.GetAssetsByClass(UCurveTable::StaticClass()->GetClassPathName(), CurveTableAssets);
+	TMultiMap<FName, FAssetData> AssetsByName;
+	for (const FAssetData& AssetData : CurveTableAssets)
+	{
+		AssetsByName.Add(AssetData.AssetName, AssetData);
+	}
+
+	auto CompileTable = [&](const UCurveTable* Table, const UCurveTable* SourceAsset)
+	{
+		TArray<uint8> Bytes;
+		if (!FAuraCompiledCurveTable::Compile(*Table, *SourceAsset, MaxLevel, Bytes, Errors)) return;
+
+		const FString PackageName = SourceAsset->GetPackage()->GetName();
+		if (const TArray<uint8>* Existing = Compiled.Find(PackageName))
+		{
+			if (*Existing != Bytes)
+			{
+				Errors.Add(FString::Printf(TEXT("%s: sources disagree"), *PackageName));
+			}
+			return;
+		}
+		Compiled.Add(PackageName, MoveTemp(Bytes));
+	};
+
+	TArray<FString> SourceFiles;
+	IFileManager::Get().FindFiles(SourceFiles, *(SourceDirectory / TEXT("CT_*.*")), true, false);
+	SourceFiles.Sort();
+	for (const FString& SourceFile : SourceFiles)
+	{
+		const FName TableName(FPaths::GetBaseFilename(SourceFile));
+		const UCurveTable* Table = ImportSourceFile(SourceDirectory / SourceFile, Errors);
+		if (Table == nullptr) continue;
+
+		TArray<FAssetData> AssetDatas;
+		AssetsByName.MultiFind(TableName, AssetDatas);
+		if (AssetDatas.Num() > 1)
+		{
+			Errors.Add(FString::Printf(TEXT("%s: %d curve table assets are named %s, compile them with -Tables= instead"), *SourceFile, AssetDatas.Num(), *TableName.ToString()));
+			continue;
+		}
+
+		const UCurveTable* SourceAsset = AssetDatas.Num() > 0 ? Cast<UCurveTable>(AssetDatas[0].GetAsset()) : nullptr;
+		if (SourceAsset == nullptr)
+		{
+			Errors.Add(FString::Printf(TEXT("%s: no curve table asset named %s"), *SourceFile, *TableName.ToString()));
+			continue;
+		}
+		CompileTable(Table, SourceAsset);
+	}
+
+	TArray<FString> Tables;
+	TablePaths.ParseIntoArray(Tables, TEXT(","));
+	for (const FString& TablePath : Tables)
+	{
+		if (const UCurveTable* Table = LoadObject<UCurveTable>(nullptr, *TablePath))
+		{
+			CompileTable(Table, Table);
+		}
+		else
+		{
+			Errors.Add(FString::Printf(TEXT("%s: could not load curve table"), *TablePath));
+		}
+	}
+
+	// Cooked builds trust the compiled files, so catch assets edited since their table was last compiled
+	if (bValidateOnly)
+	{
+		for (const FAssetData& AssetData : CurveTableAssets)
+		{
+			const FString Filename = FAuraCompiledCurves::GetCompiledFilename(AssetData.PackageName.ToString());
+			FAuraCompiledCurveTable Existing;
+			if (!FPaths::FileExists(Filename) || !Existing.Load(Filename)) continue;
+
+			const UCurveTable* Asset = Cast<UCurveTable>(AssetData.GetAsset());
+			if (Asset && Existing.GetSourceHash() != FAuraCompiledCurveTable::HashSource(*Asset))
+			{
+				Errors.Add(FString::Printf(TEXT("%s: out of date with %s"), *Filename, *AssetData.GetObjectPathString()));
+			}
+		}
+	}
+
+	for (const FString& Error : Errors)
+	{
+		UE_LOG(LogAura, Error, TEXT("%s"), *Error);
+	}
+	if (Errors.Num() > 0) return 1;
+
+	if (!bValidateOnly)
+	{
+		for (const TPair<FString, TArray<uint8>>& Pair : Compiled)
+		{
+			const FString Filename = FAuraCompiledCurves::GetCompiledFilename(Pair.Key);
+			if (!FFileHelper::SaveArrayToFile(Pair.Value, *Filename))
+			{
+				UE_LOG(LogAura, Error, TEXT("Failed to write %s"), *Filename);
+				return 1;
+			}
+			UE_LOG(LogAura, Display, TEXT("Wrote %s (%d bytes)"), *Filename, Pair.Value.Num());
+		}
+	}
+
+	UE_LOG(LogAura, Display, TEXT("%d curve tables valid"), Compiled.Num());
+	return 0;
+}
+
+UCurveTable* UAuraCompileCurvesCommandlet::ImportSourceFile(const FString& Filename, TArray<FString>& OutErrors)
+{
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension != TEXT("json") && Extension != TEXT("csv")) return nullptr;
+
+	FString Contents;
+	if (!FFileHelper::LoadFileToString(Contents, *Filename))
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s: could not read file"), *Filename));
+		return nullptr;
+	}
+
+	// A table can have both a CSV and a JSON source, keep their transient objects apart
+	const FName ObjectName = MakeUniqueObjectName(GetTransientPackage(), UCurveTable::StaticClass(), FName(FPaths::GetBaseFilename(Filename)));
+	UCurveTable* Table = NewObject<UCurveTable>(GetTransientPackage(), ObjectName);
+	const TArray<FString> Problems = Extension == TEXT("json")
+		? Table->CreateTableFromJSONString(Contents, RCIM_Linear)
+		: Table->CreateTableFromCSVString(Contents, RCIM_Linear);
+
+	for (const FString& Problem : Problems)
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s: %s"), *Filename, *Problem));
+	}
+	return Problems.Num() > 0 ? nullptr : Table;
+}
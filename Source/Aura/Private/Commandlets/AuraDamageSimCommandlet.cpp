@@ -0,0 +1,295 @@
+// Copyright Adam Thomas
+
+
+#include "Commandlets/AuraDamageSimCommandlet.h"
+#include "Commandlets/AuraCompileCurvesCommandlet.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "AbilitySystem/AuraRandomStream.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "AbilitySystemComponent.h"
+#include "Character/AuraEnemy.h"
+#include "Engine/CurveTable.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Aura/AuraLogChannels.h"
+
+namespace AuraDamageSim
+{
+	static float Eval(const UCurveTable* Table, const TCHAR* RowName, int32 Level)
+	{
+		const FRealCurve* Curve = Table ? Table->FindCurve(FName(RowName), FString(), false) : nullptr;
+		return Curve ? Curve->Eval(static_cast<float>(Level)) : 0.f;
+	}
+
+	/** A class's attributes at one level, as the damage execution captures them */
+	struct FSimAttributes
+	{
+		float Armour = 0.f;
+		float ArmourPenetration = 0.f;
+		float BlockChance = 0.f;
+		float CriticalHitChance = 0.f;
+		float CriticalHitDamage = 0.f;
+		float CriticalHitResistance = 0.f;
+		float Resistance = 0.f;
+		float MaxHealth = 0.f;
+	};
+
+	static float GetAttributeByTag(const UAbilitySystemComponent* ASC, const UAuraAttributeSet* AttributeSet, const FString& TagName)
+	{
+		const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(FName(*TagName), false);
+		const TStaticFuncPtr<FGameplayAttribute()>* Attribute = AttributeSet->TagsToAttributes.Find(Tag);
+		return Attribute ? ASC->GetNumericAttribute((*Attribute)()) : 0.f;
+	}
+
+	/**
+	 * Sets the primary attributes from the class's table, then applies the secondary attribute effect so armour, block, crit,
+	 * resistances and max health come from the same modifiers and MMCs as in game
+	 */
+	static FSimAttributes DeriveAttributes(AAuraEnemy* Character, const UCurveTable* PrimaryTable, TSubclassOf<UGameplayEffect> SecondaryAttributes,
+		const FString& ResistanceTag, int32 Level)
+	{
+		UAbilitySystemComponent* ASC = Character->GetAbilitySystemComponent();
+		const UAuraAttributeSet* AttributeSet = CastChecked<UAuraAttributeSet>(Character->GetAttributeSet());
+
+		Character->SetLevel(Level);
+		for (const TPair<FName, FRealCurve*>& Row : PrimaryTable->GetRowMap())
+		{
+			const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(Row.Key, false);
+			if (const TStaticFuncPtr<FGameplayAttribute()>* Attribute = AttributeSet->TagsToAttributes.Find(Tag))
+			{
+				ASC->SetNumericAttributeBase((*Attribute)(), Row.Value->Eval(static_cast<float>(Level)));
+			}
+		}
+
+		FGameplayEffectContextHandle ContextHandle = ASC->MakeEffectContext();
+		ContextHandle.AddSourceObject(Character);
+		const FGameplayEffectSpecHandle SpecHandle = ASC->MakeOutgoingSpec(SecondaryAttributes, Level, ContextHandle);
+		const FActiveGameplayEffectHandle ActiveHandle = ASC->ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
+
+		FSimAttributes Attributes;
+		Attributes.Armour = AttributeSet->GetArmour();
+		Attributes.ArmourPenetration = AttributeSet->GetArmourPenetration();
+		Attributes.BlockChance = AttributeSet->GetBlockChance();
+		Attributes.CriticalHitChance = AttributeSet->GetCriticalHitChance();
+		Attributes.CriticalHitDamage = AttributeSet->GetCriticalHitDamage();
+		Attributes.CriticalHitResistance = AttributeSet->GetCriticalHitResistance();
+		Attributes.Resistance = GetAttributeByTag(ASC, AttributeSet, ResistanceTag);
+		Attributes.MaxHealth = AttributeSet->GetMaxHealth();
+
+		ASC->RemoveActiveGameplayEffect(ActiveHandle);
+		return Attributes;
+	}
+}
+
+UAuraDamageSimCommandlet::UAuraDamageSimCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UAuraDamageSimCommandlet::Main(const FString& Params)
+{
+	using namespace AuraDamageSim;
+
+	FString SourceDirectory = FPaths::ProjectDir() / TEXT("Data");
+	FParse::Value(*Params, TEXT("Source="), SourceDirectory);
+
+	FString Ability = TEXT("Abilities.Firebolt");
+	FParse::Value(*Params, TEXT("Ability="), Ability);
+
+	FString DamageType = TEXT("Fire");
+	FParse::Value(*Params, TEXT("DamageType="), DamageType);
+
+	FString LevelList = TEXT("1,5,10,20,40");
+	FParse::Value(*Params, TEXT("Levels="), LevelList);
+
+	int32 NumHits = 100000;
+	FParse::Value(*Params, TEXT("Hits="), NumHits);
+	NumHits = FMath::Max(NumHits, 1);
+
+	float HitsPerSecond = 1.f;
+	FParse::Value(*Params, TEXT("HitsPerSecond="), HitsPerSecond);
+
+	FString ClassInfoPath = TEXT("/Game/Blueprints/AbilitySystem/Data/DA_CharacterClassInfo.DA_CharacterClassInfo");
+	FParse::Value(*Params, TEXT("ClassInfo="), ClassInfoPath);
+
+	uint64 Seed = 1;
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	TArray<FString> Errors;
+
+	const UCurveTable* DamageTable = LoadSourceTable(SourceDirectory, TEXT("CT_Damage"), Errors);
+	const UCharacterClassInfo* ClassInfo = LoadObject<UCharacterClassInfo>(nullptr, *ClassInfoPath);
+	if (ClassInfo == nullptr || !ClassInfo->SecondaryAttributes)
+	{
+		Errors.Add(FString::Printf(TEXT("%s: could not load character class info with a secondary attribute effect"), *ClassInfoPath));
+	}
+
+	const UCurveTable* Coefficients = LoadSourceTable(SourceDirectory, TEXT("CT_DamageCalculationCoefficients"), Errors);
+	if (Coefficients == nullptr && ClassInfo)
+	{
+		Coefficients = ClassInfo->DamageCalculationCoefficients;
+	}
+
+	// Class name to its primary attribute table
+	TMap<FString, const UCurveTable*> Classes;
+	TArray<FString> PrimaryFiles;
+	IFileManager::Get().FindFiles(PrimaryFiles, *(SourceDirectory / TEXT("CT_PrimaryAttributes_*.*")), true, false);
+	PrimaryFiles.Sort();
+	for (const FString& PrimaryFile : PrimaryFiles)
+	{
+		const FString ClassName = FPaths::GetBaseFilename(PrimaryFile).RightChop(FCString::Strlen(TEXT("CT_PrimaryAttributes_")));
+		if (Classes.Contains(ClassName)) continue;
+
+		if (const UCurveTable* Primary = LoadSourceTable(SourceDirectory, FPaths::GetBaseFilename(PrimaryFile), Errors))
+		{
+			Classes.Add(ClassName, Primary);
+		}
+	}
+
+	if (DamageTable == nullptr || Coefficients == nullptr || Classes.Num() == 0)
+	{
+		Errors.Add(TEXT("CT_Damage, the damage calculation coefficients and at least one CT_PrimaryAttributes_<Class> source are required"));
+	}
+
+	for (const FString& Error : Errors)
+	{
+		UE_LOG(LogAura, Error, TEXT("%s"), *Error);
+	}
+	if (Errors.Num() > 0) return 1;
+
+	TArray<FString> LevelStrings;
+	LevelList.ParseIntoArray(LevelStrings, TEXT(","));
+	TArray<int32> Levels;
+	for (const FString& LevelString : LevelStrings)
+	{
+		Levels.Add(FCString::Atoi(*LevelString));
+	}
+
+	const FString ResistanceTag = TEXT("Attributes.Resistances.") + DamageType;
+
+	// Secondary attributes are derived once per class and level on a character in a throwaway world
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("AuraDamageSimWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	const FTransform SpawnTransform;
+	AAuraEnemy* Character = World->SpawnActorDeferred<AAuraEnemy>(AAuraEnemy::StaticClass(), SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	Character->AutoPossessAI = EAutoPossessAI::Disabled;
+	Character->FinishSpawning(SpawnTransform);
+
+	TMap<FString, TArray<FSimAttributes>> ClassAttributes;
+	for (const TPair<FString, const UCurveTable*>& Class : Classes)
+	{
+		TArray<FSimAttributes>& PerLevel = ClassAttributes.Add(Class.Key);
+		for (const int32 Level : Levels)
+		{
+			PerLevel.Add(DeriveAttributes(Character, Class.Value, ClassInfo->SecondaryAttributes, ResistanceTag, Level));
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	// One struct of arrays reused for every matchup
+	TArray<float> Damage, BlockRoll, CriticalHitRoll, TargetBlockChance, TargetArmour, SourceArmourPenetration,
+		SourceCriticalHitChance, TargetCriticalHitResistance, SourceCriticalHitDamage, OutDamage;
+	for (TArray<float>* Array : { &Damage, &BlockRoll, &CriticalHitRoll, &TargetBlockChance, &TargetArmour, &SourceArmourPenetration,
+		&SourceCriticalHitChance, &TargetCriticalHitResistance, &SourceCriticalHitDamage, &OutDamage })
+	{
+		Array->SetNumUninitialized(NumHits);
+	}
+
+	FAuraDamageKernel::FBatch Batch;
+	Batch.Num = NumHits;
+	Batch.Damage = Damage.GetData();
+	Batch.BlockRoll = BlockRoll.GetData();
+	Batch.CriticalHitRoll = CriticalHitRoll.GetData();
+	Batch.TargetBlockChance = TargetBlockChance.GetData();
+	Batch.TargetArmour = TargetArmour.GetData();
+	Batch.SourceArmourPenetration = SourceArmourPenetration.GetData();
+	Batch.SourceCriticalHitChance = SourceCriticalHitChance.GetData();
+	Batch.TargetCriticalHitResistance = TargetCriticalHitResistance.GetData();
+	Batch.SourceCriticalHitDamage = SourceCriticalHitDamage.GetData();
+
+	FAuraRandomStream RollStream(Seed);
+	int64 TotalHits = 0;
+	double KernelSeconds = 0.0;
+
+	UE_LOG(LogAura, Display, TEXT("%s, %d hits per matchup, %.2f hits per second"), *Ability, NumHits, HitsPerSecond);
+	UE_LOG(LogAura, Display, TEXT("%-14s %-14s %6s %12s %10s %10s"), TEXT("Attacker"), TEXT("Defender"), TEXT("Level"), TEXT("Damage/Hit"), TEXT("DPS"), TEXT("TTK (s)"));
+
+	for (int32 LevelIndex = 0; LevelIndex < Levels.Num(); ++LevelIndex)
+	{
+		const int32 Level = Levels[LevelIndex];
+		const float BaseDamage = Eval(DamageTable, *Ability, Level);
+
+		Batch.ArmourPenetrationCoefficient = Eval(Coefficients, TEXT("ArmourPenetration"), Level);
+		Batch.EffectiveArmourCoefficient = Eval(Coefficients, TEXT("EffectiveArmour"), Level);
+		Batch.CriticalHitResistanceCoefficient = Eval(Coefficients, TEXT("CriticalHitResistance"), Level);
+
+		for (const TPair<FString, TArray<FSimAttributes>>& Attacker : ClassAttributes)
+		{
+			const FSimAttributes& Source = Attacker.Value[LevelIndex];
+
+			for (const TPair<FString, TArray<FSimAttributes>>& Defender : ClassAttributes)
+			{
+				const FSimAttributes& Target = Defender.Value[LevelIndex];
+				const float ResistedDamage = FAuraDamageKernel::ApplyResistance(BaseDamage, Target.Resistance);
+
+				for (int32 Index = 0; Index < NumHits; ++Index)
+				{
+					Damage[Index] = ResistedDamage;
+					BlockRoll[Index] = static_cast<float>(RollStream.RandRange(1, 100));
+					CriticalHitRoll[Index] = static_cast<float>(RollStream.RandRange(1, 100));
+					TargetBlockChance[Index] = Target.BlockChance;
+					TargetArmour[Index] = Target.Armour;
+					SourceArmourPenetration[Index] = Source.ArmourPenetration;
+					SourceCriticalHitChance[Index] = Source.CriticalHitChance;
+					TargetCriticalHitResistance[Index] = Target.CriticalHitResistance;
+					SourceCriticalHitDamage[Index] = Source.CriticalHitDamage;
+				}
+
+				const double StartTime = FPlatformTime::Seconds();
+				FAuraDamageKernel::ComputeBatch(Batch, OutDamage.GetData());
+				KernelSeconds += FPlatformTime::Seconds() - StartTime;
+				TotalHits += NumHits;
+
+				double TotalDamage = 0.0;
+				for (const float HitDamage : OutDamage)
+				{
+					TotalDamage += HitDamage;
+				}
+
+				const float DamagePerHit = static_cast<float>(TotalDamage / NumHits);
+				const float DPS = DamagePerHit * HitsPerSecond;
+				const float TimeToKill = DPS > 0.f ? Target.MaxHealth / DPS : TNumericLimits<float>::Max();
+
+				UE_LOG(LogAura, Display, TEXT("%-14s %-14s %6d %12.2f %10.2f %10.2f"), *Attacker.Key, *Defender.Key, Level, DamagePerHit, DPS, TimeToKill);
+			}
+		}
+	}
+
+	UE_LOG(LogAura, Display, TEXT("Kernel evaluated %lld hits in %.3f ms"), TotalHits, KernelSeconds * 1000.0);
+	return 0;
+}
+
+UCurveTable* UAuraDamageSimCommandlet::LoadSourceTable(const FString& SourceDirectory, const FString& TableName, TArray<FString>& OutErrors) const
+{
+	for (const TCHAR* Extension : { TEXT(".json"), TEXT(".csv") })
+	{
+		const FString Filename = SourceDirectory / TableName + Extension;
+		if (FPaths::FileExists(Filename))
+		{
+			return UAuraCompileCurvesCommandlet::ImportSourceFile(Filename, OutErrors);
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,175 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraAudioSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "Aura/AuraStats.h"
+#include "Aura/Aura.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Requested"), STAT_AuraAudioRequested, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Played"), STAT_AuraAudioPlayed, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Merged"), STAT_AuraAudioMerged, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Over Budget"), STAT_AuraAudioOverBudget, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Active Loops"), STAT_AuraAudioActiveLoops, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Pooled Loops"), STAT_AuraAudioPooledLoops, STATGROUP_Aura);
+
+static TAutoConsoleVariable<float> CVarAuraAudioMergeWindow(
+	TEXT("Aura.Audio.MergeWindow"),
+	0.05f,
+	TEXT("Seconds within which the same sound fired near an existing voice is merged into it."));
+
+static TAutoConsoleVariable<float> CVarAuraAudioMergeRadius(
+	TEXT("Aura.Audio.MergeRadius"),
+	300.f,
+	TEXT("Distance within which the same sound is merged."));
+
+static TAutoConsoleVariable<int32> CVarAuraAudioMaxVoicesPerClass(
+	TEXT("Aura.Audio.MaxVoicesPerClass"),
+	8,
+	TEXT("Maximum concurrent combat one shots per sound class."));
+
+static TAutoConsoleVariable<int32> CVarAuraAudioMaxLoops(
+	TEXT("Aura.Audio.MaxLoops"),
+	24,
+	TEXT("Maximum concurrent pooled projectile loops."));
+
+// Voices of sounds without a usable duration are counted against the budget for this long
+static constexpr float MaxTrackedVoiceDuration = 5.f;
+
+void UAuraAudioSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	ActiveVoices.RemoveAllSwap([Now](const FAuraActiveVoice& Voice) { return Voice.EndTime <= Now; }, false);
+}
+
+TStatId UAuraAudioSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraAudioSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WITH_AURA_COSMETICS && (WorldType == EWorldType::Game || WorldType == EWorldType::PIE);
+}
+
+void UAuraAudioSubsystem::Deinitialize()
+{
+	FreeLoopingComponents.Reset();
+	PoolOwner = nullptr;
+	Super::Deinitialize();
+}
+
+bool UAuraAudioSubsystem::ShouldPlay() const
+{
+	return GetWorld()->GetNetMode() != NM_DedicatedServer;
+}
+
+bool UAuraAudioSubsystem::PlayCombatSound(USoundBase* Sound, const FVector& Location, const FRotator& Rotation)
+{
+	if (Sound == nullptr || !ShouldPlay()) return false;
+
+	++VoicesRequested;
+	INC_DWORD_STAT(STAT_AuraAudioRequested);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float MergeWindow = CVarAuraAudioMergeWindow.GetValueOnGameThread();
+	const float MergeRadiusSquared = FMath::Square(CVarAuraAudioMergeRadius.GetValueOnGameThread());
+	USoundClass* SoundClass = Sound->GetSoundClass();
+
+	int32 NumVoicesInClass = 0;
+	for (const FAuraActiveVoice& Voice : ActiveVoices)
+	{
+		if (Voice.Sound == Sound && Now - Voice.StartTime <= MergeWindow && FVector::DistSquared(Voice.Location, Location) <= MergeRadiusSquared)
+		{
+			INC_DWORD_STAT(STAT_AuraAudioMerged);
+			return false;
+		}
+		if (Voice.SoundClass == SoundClass && Voice.EndTime > Now)
+		{
+			++NumVoicesInClass;
+		}
+	}
+
+	if (NumVoicesInClass >= CVarAuraAudioMaxVoicesPerClass.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_AuraAudioOverBudget);
+		return false;
+	}
+
+	UGameplayStatics::PlaySoundAtLocation(this, Sound, Location, Rotation);
+
+	const float Duration = Sound->GetDuration();
+	FAuraActiveVoice& Voice = ActiveVoices.AddDefaulted_GetRef();
+	Voice.Sound = Sound;
+	Voice.SoundClass = SoundClass;
+	Voice.Location = Location;
+	Voice.StartTime = Now;
+	Voice.EndTime = Now + (Duration > 0.f && Duration < MaxTrackedVoiceDuration ? Duration : MaxTrackedVoiceDuration);
+
+	++VoicesPlayed;
+	INC_DWORD_STAT(STAT_AuraAudioPlayed);
+	return true;
+}
+
+UAudioComponent* UAuraAudioSubsystem::AcquireLoopingSound(USoundBase* Sound, USceneComponent* AttachToComponent)
+{
+	if (Sound == nullptr || AttachToComponent == nullptr || !ShouldPlay()) return nullptr;
+
+	++VoicesRequested;
+	INC_DWORD_STAT(STAT_AuraAudioRequested);
+
+	if (NumActiveLoops >= CVarAuraAudioMaxLoops.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_AuraAudioOverBudget);
+		return nullptr;
+	}
+
+	UAudioComponent* AudioComponent = nullptr;
+	while (AudioComponent == nullptr && FreeLoopingComponents.Num() > 0)
+	{
+		AudioComponent = FreeLoopingComponents.Pop(false);
+		if (!IsValid(AudioComponent)) AudioComponent = nullptr;
+	}
+
+	if (AudioComponent == nullptr)
+	{
+		if (!IsValid(PoolOwner))
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.ObjectFlags |= RF_Transient;
+			PoolOwner = GetWorld()->SpawnActor<AActor>(SpawnParams);
+		}
+		AudioComponent = NewObject<UAudioComponent>(PoolOwner);
+		AudioComponent->bAutoActivate = false;
+		AudioComponent->bAutoDestroy = false;
+		AudioComponent->RegisterComponent();
+	}
+
+	AudioComponent->AttachToComponent(AttachToComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	AudioComponent->SetSound(Sound);
+	AudioComponent->Play();
+
+	++NumActiveLoops;
+	++VoicesPlayed;
+	INC_DWORD_STAT(STAT_AuraAudioPlayed);
+	SET_DWORD_STAT(STAT_AuraAudioActiveLoops, NumActiveLoops);
+	SET_DWORD_STAT(STAT_AuraAudioPooledLoops, FreeLoopingComponents.Num());
+	return AudioComponent;
+}
+
+void UAuraAudioSubsystem::ReleaseLoopingSound(UAudioComponent* AudioComponent)
+{
+	if (!IsValid(AudioComponent)) return;
+
+	AudioComponent->Stop();
+	AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	FreeLoopingComponents.Add(AudioComponent);
+
+	NumActiveLoops = FMath::Max(NumActiveLoops - 1, 0);
+	SET_DWORD_STAT(STAT_AuraAudioActiveLoops, NumActiveLoops);
+	SET_DWORD_STAT(STAT_AuraAudioPooledLoops, FreeLoopingComponents.Num());
+}
@@ -0,0 +1,69 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraCombatLog.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+
+static_assert(sizeof(FAuraCombatLog::FHeader) % alignof(FAuraCombatLogRecord) == 0, "Records must stay aligned after the header");
+
+FAuraCombatLog::FAuraCombatLog() = default;
+FAuraCombatLog::~FAuraCombatLog() = default;
+
+FAuraCombatLog::FHeader FAuraCombatLog::MakeHeader()
+{
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.RecordSize = sizeof(FAuraCombatLogRecord);
+	Header.Reserved = 0;
+	Header.StartTicks = FDateTime::UtcNow().GetTicks();
+	Header.Reserved2 = 0;
+	return Header;
+}
+
+bool FAuraCombatLog::Load(const FString& Filename)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*Filename));
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+		if (MappedRegion.IsValid())
+		{
+			return Parse(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+		}
+	}
+
+	if (!FFileHelper::LoadFileToArray(LoadedBytes, *Filename, FILEREAD_Silent)) return false;
+	return Parse(LoadedBytes.GetData(), LoadedBytes.Num());
+}
+
+bool FAuraCombatLog::Parse(const uint8* Data, int64 Size)
+{
+	if (Size < static_cast<int64>(sizeof(FHeader))) return false;
+
+	FHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(FHeader));
+	if (Header.Magic != Magic || Header.Version != Version || Header.RecordSize != sizeof(FAuraCombatLogRecord)) return false;
+
+	Records = reinterpret_cast<const FAuraCombatLogRecord*>(Data + sizeof(FHeader));
+	NumRecords = static_cast<int32>((Size - sizeof(FHeader)) / sizeof(FAuraCombatLogRecord));
+	StartTicks = Header.StartTicks;
+	return true;
+}
+
+const TCHAR* FAuraCombatLog::LexToString(EAuraCombatLogRecordType Type)
+{
+	switch (Type)
+	{
+	case EAuraCombatLogRecordType::Hit: return TEXT("Hit");
+	case EAuraCombatLogRecordType::Debuff: return TEXT("Debuff");
+	case EAuraCombatLogRecordType::Death: return TEXT("Death");
+	case EAuraCombatLogRecordType::XPGrant: return TEXT("XPGrant");
+	case EAuraCombatLogRecordType::LevelUp: return TEXT("LevelUp");
+	}
+	return TEXT("Unknown");
+}
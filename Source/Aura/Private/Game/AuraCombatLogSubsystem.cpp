@@ -0,0 +1,249 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraCombatLogSubsystem.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemBlueprintLibrary.h"
+#include "GameplayTagsManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Interaction/CombatInterface.h"
+#include "Aura/AuraLogChannels.h"
+
+static TAutoConsoleVariable<bool> CVarAuraCombatLog(
+	TEXT("Aura.CombatLog"),
+	true,
+	TEXT("Record hits, debuffs, deaths, XP grants and level ups to Saved/CombatLogs on servers. Read when the world begins play."));
+
+static TAutoConsoleVariable<int32> CVarAuraCombatLogMaxFileMB(
+	TEXT("Aura.CombatLog.MaxFileMB"),
+	64,
+	TEXT("Size at which the combat log rolls over to a new file."));
+
+static TAutoConsoleVariable<int32> CVarAuraCombatLogMaxFiles(
+	TEXT("Aura.CombatLog.MaxFiles"),
+	50,
+	TEXT("Combat logs kept in Saved/CombatLogs, the oldest are deleted when a world begins play. 0 keeps them all."));
+
+static TAutoConsoleVariable<float> CVarAuraCombatLogFlushSeconds(
+	TEXT("Aura.CombatLog.FlushSeconds"),
+	1.f,
+	TEXT("Longest time records are buffered before being handed to the writer."));
+
+namespace AuraCombatLog
+{
+	// Flushes before Aura.CombatLog.FlushSeconds once a batch is this large
+	static constexpr int32 MaxPendingRecords = 1024;
+
+	/** Deletes the oldest logs in Directory so a new one can be written without going over MaxFiles */
+	static void PruneLogs(const FString& Directory, int32 MaxFiles)
+	{
+		if (MaxFiles <= 0) return;
+
+		IFileManager& FileManager = IFileManager::Get();
+		TArray<FString> Filenames;
+		FileManager.FindFiles(Filenames, *(Directory / TEXT("*.auralog")), true, false);
+		if (Filenames.Num() < MaxFiles) return;
+
+		TArray<TPair<FDateTime, FString>> Logs;
+		Logs.Reserve(Filenames.Num());
+		for (const FString& Filename : Filenames)
+		{
+			const FString Path = Directory / Filename;
+			Logs.Emplace(FileManager.GetTimeStamp(*Path), Path);
+		}
+		Logs.Sort([](const TPair<FDateTime, FString>& A, const TPair<FDateTime, FString>& B) { return A.Key < B.Key; });
+
+		const int32 NumToDelete = Logs.Num() - MaxFiles + 1;
+		for (int32 i = 0; i < NumToDelete; ++i)
+		{
+			if (!FileManager.Delete(*Logs[i].Value))
+			{
+				UE_LOG(LogAura, Warning, TEXT("Could not delete old combat log %s"), *Logs[i].Value);
+			}
+		}
+		UE_LOG(LogAura, Log, TEXT("Deleted %d old combat logs, Aura.CombatLog.MaxFiles is %d"), NumToDelete, MaxFiles);
+	}
+}
+
+/** Owns the open log file, only touched by the write tasks once created */
+class FAuraCombatLogWriter
+{
+public:
+
+	FAuraCombatLogWriter(const FString& InBaseFilename, int64 InMaxFileBytes)
+		: BaseFilename(InBaseFilename)
+		, MaxFileBytes(InMaxFileBytes)
+	{
+	}
+
+	void Write(const TArray<FAuraCombatLogRecord>& Records)
+	{
+		const int64 NumBytes = Records.Num() * sizeof(FAuraCombatLogRecord);
+		if (!File.IsValid() || File->Tell() + NumBytes > MaxFileBytes)
+		{
+			OpenNextFile();
+		}
+		if (File.IsValid())
+		{
+			File->Serialize(const_cast<FAuraCombatLogRecord*>(Records.GetData()), NumBytes);
+			File->Flush();
+		}
+	}
+
+private:
+
+	void OpenNextFile()
+	{
+		File.Reset();
+
+		const FString Filename = FString::Printf(TEXT("%s_%03d.auralog"), *BaseFilename, FileIndex++);
+		File.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+		if (!File.IsValid())
+		{
+			UE_LOG(LogAura, Warning, TEXT("Could not open combat log %s"), *Filename);
+			return;
+		}
+
+		FAuraCombatLog::FHeader Header = FAuraCombatLog::MakeHeader();
+		File->Serialize(&Header, sizeof(Header));
+	}
+
+	FString BaseFilename;
+	int64 MaxFileBytes = 0;
+	int32 FileIndex = 0;
+	TUniquePtr<FArchive> File;
+};
+
+void UAuraCombatLogSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client || !CVarAuraCombatLog.GetValueOnGameThread()) return;
+
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("CombatLogs");
+	IFileManager::Get().MakeDirectory(*Directory, true);
+	AuraCombatLog::PruneLogs(Directory, CVarAuraCombatLogMaxFiles.GetValueOnGameThread());
+
+	const FString BaseFilename = Directory / FString::Printf(TEXT("%s_%s"), *InWorld.GetMapName(), *FDateTime::Now().ToString());
+	const int64 MaxFileBytes = FMath::Max<int64>(CVarAuraCombatLogMaxFileMB.GetValueOnGameThread(), 1) * 1024 * 1024;
+	Writer = MakeShared<FAuraCombatLogWriter, ESPMode::ThreadSafe>(BaseFilename, MaxFileBytes);
+	LastFlushTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogAura, Log, TEXT("Recording combat log to %s_*.auralog"), *BaseFilename);
+}
+
+void UAuraCombatLogSubsystem::Deinitialize()
+{
+	Flush();
+	LastWrite.Wait();
+	Writer.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAuraCombatLogSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingRecords.Num() >= AuraCombatLog::MaxPendingRecords
+		|| (PendingRecords.Num() > 0 && FPlatformTime::Seconds() - LastFlushTime >= CVarAuraCombatLogFlushSeconds.GetValueOnGameThread()))
+	{
+		Flush();
+	}
+}
+
+TStatId UAuraCombatLogSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraCombatLogSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraCombatLogSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraCombatLogSubsystem::Flush()
+{
+	LastFlushTime = FPlatformTime::Seconds();
+	if (PendingRecords.Num() == 0 || !Writer.IsValid()) return;
+
+	LastWrite = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Writer = Writer, Records = MoveTemp(PendingRecords)]()
+		{
+			Writer->Write(Records);
+		},
+		UE::Tasks::Prerequisites(LastWrite));
+
+	PendingRecords.Reset(AuraCombatLog::MaxPendingRecords);
+}
+
+FAuraCombatLogRecord& UAuraCombatLogSubsystem::AddRecord(EAuraCombatLogRecordType Type, const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC)
+{
+	FAuraCombatLogRecord& Record = PendingRecords.AddZeroed_GetRef();
+	Record.Time = GetWorld()->GetTimeSeconds();
+	Record.Type = Type;
+	Record.SourceId = SourceASC ? SourceASC->GetUniqueID() : 0;
+	Record.TargetId = TargetASC ? TargetASC->GetUniqueID() : 0;
+
+	auto Describe = [](const UAbilitySystemComponent* ASC, uint8& OutClass, uint8& OutLevel)
+	{
+		AActor* Avatar = ASC ? ASC->GetAvatarActor() : nullptr;
+		if (IsValid(Avatar) && Avatar->Implements<UCombatInterface>())
+		{
+			OutClass = static_cast<uint8>(ICombatInterface::Execute_GetCharacterClass(Avatar));
+			OutLevel = static_cast<uint8>(FMath::Clamp(ICombatInterface::Execute_GetPlayerLevel(Avatar), 0, MAX_uint8));
+		}
+	};
+	Describe(SourceASC, Record.SourceClass, Record.SourceLevel);
+	Describe(TargetASC, Record.TargetClass, Record.TargetLevel);
+	return Record;
+}
+
+void UAuraCombatLogSubsystem::RecordHit(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, const FGameplayTag& DamageType, uint64 RollSeed,
+	const FAuraCombatLogHit& Hit, EAuraCombatLogFlags Flags, float FinalDamage)
+{
+	if (!IsRecording()) return;
+
+	FAuraCombatLogRecord& Record = AddRecord(EAuraCombatLogRecordType::Hit, SourceASC, TargetASC);
+	Record.RollSeed = RollSeed;
+	Record.Flags = Flags;
+	Record.DamageType = DamageType.IsValid() ? UGameplayTagsManager::Get().GetNetIndexFromTag(DamageType) : 0;
+	Record.Value = FinalDamage;
+	Record.Hit = Hit;
+}
+
+void UAuraCombatLogSubsystem::RecordDebuff(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, const FGameplayTag& DamageType,
+	float DamagePerTick, float Duration, float Frequency)
+{
+	if (!IsRecording()) return;
+
+	FAuraCombatLogRecord& Record = AddRecord(EAuraCombatLogRecordType::Debuff, SourceASC, TargetASC);
+	Record.DamageType = DamageType.IsValid() ? UGameplayTagsManager::Get().GetNetIndexFromTag(DamageType) : 0;
+	Record.Value = DamagePerTick;
+	Record.Debuff.Duration = Duration;
+	Record.Debuff.Frequency = Frequency;
+}
+
+void UAuraCombatLogSubsystem::RecordDeath(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC)
+{
+	if (!IsRecording()) return;
+
+	AddRecord(EAuraCombatLogRecordType::Death, SourceASC, TargetASC);
+}
+
+void UAuraCombatLogSubsystem::RecordXPGrant(const AActor* Recipient, int32 XP)
+{
+	if (!IsRecording()) return;
+
+	const UAbilitySystemComponent* RecipientASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(const_cast<AActor*>(Recipient));
+	AddRecord(EAuraCombatLogRecordType::XPGrant, RecipientASC, RecipientASC).Value = static_cast<float>(XP);
+}
+
+void UAuraCombatLogSubsystem::RecordLevelUp(const AActor* Recipient, int32 NewLevel)
+{
+	if (!IsRecording()) return;
+
+	const UAbilitySystemComponent* RecipientASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(const_cast<AActor*>(Recipient));
+	AddRecord(EAuraCombatLogRecordType::LevelUp, RecipientASC, RecipientASC).Value = static_cast<float>(NewLevel);
+}
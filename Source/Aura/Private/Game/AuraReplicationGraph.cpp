@@ -0,0 +1,245 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraReplicationGraph.h"
+#include "ReplicationGraphTypes.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Actor/AuraEffectActor.h"
+#include "Actor/AuraProjectile.h"
+#include "Character/AuraCharacter.h"
+#include "Character/AuraEnemy.h"
+#include "Player/AuraPlayerState.h"
+
+static TAutoConsoleVariable<float> CVarAuraRepGraphCellSize(
+	TEXT("Aura.RepGraph.CellSize"),
+	10000.f,
+	TEXT("Size of a replication grid cell in world units. Read when the net driver starts."));
+
+static TAutoConsoleVariable<float> CVarAuraRepGraphSpatialBias(
+	TEXT("Aura.RepGraph.SpatialBias"),
+	-150000.f,
+	TEXT("X and Y of the replication grid's origin, below the lowest coordinate an actor can reach. Read when the net driver starts."));
+
+static TAutoConsoleVariable<int32> CVarAuraRepGraphProjectileChannelTimeout(
+	TEXT("Aura.RepGraph.ProjectileChannelTimeout"),
+	4,
+	TEXT("Frames a projectile's actor channel stays open once it is no longer relevant. Read when the net driver starts."));
+
+void UAuraReplicationGraphNode_Projectiles::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Projectiles.Add(ActorInfo.Actor);
+}
+
+bool UAuraReplicationGraphNode_Projectiles::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	return Projectiles.RemoveSwap(ActorInfo.Actor, false) > 0;
+}
+
+void UAuraReplicationGraphNode_Projectiles::NotifyResetAllNetworkActors()
+{
+	Projectiles.Reset();
+	GatheredLists.Reset();
+}
+
+void UAuraReplicationGraphNode_Projectiles::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	FActorRepListRefView& GatheredList = GatheredLists.FindOrAdd(&Params.ConnectionManager);
+	GatheredList.Reset();
+
+	for (AActor* Projectile : Projectiles)
+	{
+		const FVector Location = Projectile->GetActorLocation();
+		for (const FNetViewer& Viewer : Params.Viewers)
+		{
+			if (FVector::DistSquared(Location, Viewer.ViewLocation) <= CullDistanceSquared)
+			{
+				GatheredList.Add(Projectile);
+				break;
+			}
+		}
+	}
+
+	if (GatheredList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(GatheredList);
+	}
+}
+
+void UAuraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	Super::GatherActorListsForConnection(Params);
+
+	// Other players' states go through the frequency limiter, the owner's XP, level and points should not lag behind
+	OwnerActorList.Reset();
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const APlayerController* PC = Cast<APlayerController>(Viewer.InViewer);
+		if (PC && PC->PlayerState)
+		{
+			OwnerActorList.Add(PC->PlayerState);
+		}
+	}
+
+	if (OwnerActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(OwnerActorList);
+	}
+}
+
+UAuraReplicationGraph::UAuraReplicationGraph()
+{
+	ReplicationActorChannelClass = UActorChannel::StaticClass();
+}
+
+void UAuraReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ClassRepNodePolicies.Set(AInfo::StaticClass(), EAuraClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EAuraClassRepNodeMapping::PlayerState);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EAuraClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EAuraClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AAuraCharacter::StaticClass(), EAuraClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AAuraEnemy::StaticClass(), EAuraClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AAuraEffectActor::StaticClass(), EAuraClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(AAuraProjectile::StaticClass(), EAuraClassRepNodeMapping::Projectile);
+	ClassRepNodePolicies.Set(AAuraPlayerState::StaticClass(), EAuraClassRepNodeMapping::PlayerState);
+
+	// Blueprint classes loaded later find the settings of their closest native parent
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		const UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated()) continue;
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_"))) continue;
+
+		const EAuraClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+		const bool bSpatialize = Mapping == EAuraClassRepNodeMapping::Spatialize_Static
+			|| Mapping == EAuraClassRepNodeMapping::Spatialize_Dynamic
+			|| Mapping == EAuraClassRepNodeMapping::Spatialize_Dormancy;
+
+		FClassReplicationInfo Info;
+		InitClassReplicationInfo(Info, Class, bSpatialize);
+		if (Mapping == EAuraClassRepNodeMapping::Projectile)
+		{
+			Info.ActorChannelFrameTimeout = FMath::Max(CVarAuraRepGraphProjectileChannelTimeout.GetValueOnGameThread(), 1);
+		}
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, Info);
+	}
+}
+
+void UAuraReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = CVarAuraRepGraphCellSize.GetValueOnGameThread();
+	GridNode->SpatialBias = FVector2D(CVarAuraRepGraphSpatialBias.GetValueOnGameThread());
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	ProjectileNode = CreateNewNode<UAuraReplicationGraphNode_Projectiles>();
+	ProjectileNode->CullDistanceSquared = GetDefault<AAuraProjectile>()->NetCullDistanceSquared;
+	AddGlobalGraphNode(ProjectileNode);
+
+	// Finds the player states itself and spreads them across frames
+	PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UAuraReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager)
+{
+	Super::InitConnectionGraphNodes(ConnectionManager);
+
+	UAuraReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UAuraReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, ConnectionManager);
+}
+
+void UAuraReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EAuraClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	case EAuraClassRepNodeMapping::Projectile:
+		ProjectileNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UAuraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EAuraClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Projectile:
+		ProjectileNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+EAuraClassRepNodeMapping UAuraReplicationGraph::GetMappingPolicy(const UClass* Class)
+{
+	if (const EAuraClassRepNodeMapping* Mapping = ClassRepNodePolicies.Get(Class))
+	{
+		return *Mapping;
+	}
+
+	// Classes without an explicit policy are routed by their relevancy settings and cached
+	EAuraClassRepNodeMapping Mapping = EAuraClassRepNodeMapping::Spatialize_Dynamic;
+	const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	if (ActorCDO == nullptr || ActorCDO->bOnlyRelevantToOwner)
+	{
+		Mapping = EAuraClassRepNodeMapping::NotRouted;
+	}
+	else if (ActorCDO->bAlwaysRelevant)
+	{
+		Mapping = EAuraClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if (ActorCDO->NetDormancy > DORM_Awake)
+	{
+		Mapping = EAuraClassRepNodeMapping::Spatialize_Dormancy;
+	}
+
+	ClassRepNodePolicies.Set(Class, Mapping);
+	return Mapping;
+}
+
+void UAuraReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, const UClass* Class, bool bSpatialize) const
+{
+	const AActor* ActorCDO = CastChecked<AActor>(Class->GetDefaultObject());
+	if (bSpatialize)
+	{
+		Info.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+	}
+	Info.ReplicationPeriodFrame = FMath::Max<uint32>(GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency), 1);
+}
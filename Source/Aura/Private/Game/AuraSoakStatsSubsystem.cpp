@@ -0,0 +1,240 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraSoakStatsSubsystem.h"
+#include "CoreGlobals.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+#include "Aura/AuraLogChannels.h"
+
+static TAutoConsoleVariable<float> CVarAuraSoakSampleSeconds(
+	TEXT("Aura.Soak.SampleSeconds"),
+	1.f,
+	TEXT("Seconds between the rows -AuraSoakCsv writes."));
+
+namespace AuraSoakStats
+{
+	static void WriteLine(FArchive* File, const FString& Line)
+	{
+		if (File == nullptr) return;
+
+		const FTCHARToUTF8 Utf8Line(*(Line + TEXT("\n")));
+		File->Serialize(const_cast<ANSICHAR*>(Utf8Line.Get()), Utf8Line.Length());
+	}
+}
+
+bool UAuraSoakStatsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString CsvFilename;
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Value(FCommandLine::Get(), TEXT("AuraSoakCsv="), CsvFilename);
+}
+
+void UAuraSoakStatsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FString CsvFilename;
+	FParse::Value(FCommandLine::Get(), TEXT("AuraSoakCsv="), CsvFilename);
+	CsvBaseFilename = FPaths::GetPath(CsvFilename) / FPaths::GetBaseFilename(CsvFilename);
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(CsvFilename), true);
+
+	SampleFile.Reset(IFileManager::Get().CreateFileWriter(*(CsvBaseFilename + TEXT(".csv"))));
+	ConnectionFile.Reset(IFileManager::Get().CreateFileWriter(*(CsvBaseFilename + TEXT("_Connections.csv"))));
+	if (!SampleFile.IsValid() || !ConnectionFile.IsValid())
+	{
+		UE_LOG(LogAura, Warning, TEXT("Could not open soak stats files %s*.csv"), *CsvBaseFilename);
+	}
+
+	AuraSoakStats::WriteLine(SampleFile.Get(), TEXT("Time,Connections,FrameMs,MaxFrameMs,GameThreadMs,ReplicationMs,OutBytesPerSecond,InBytesPerSecond,OutBytesPerConnection,RPCsPerSecond,GCs,GCMs,UObjects,Actors,UsedPhysicalMB"));
+	AuraSoakStats::WriteLine(ConnectionFile.Get(), TEXT("Time,Connection,Player,OutBytesPerSecond,InBytesPerSecond,PingMs"));
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UAuraSoakStatsSubsystem::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UAuraSoakStatsSubsystem::OnPostGarbageCollect);
+
+	// Bound before the net driver exists so these run either side of its TickFlush, which is where the server replicates actors
+	TickFlushHandle = GetWorld()->TickFlushEvent.AddUObject(this, &UAuraSoakStatsSubsystem::OnTickFlush);
+	PostTickFlushHandle = GetWorld()->PostTickFlushEvent.AddUObject(this, &UAuraSoakStatsSubsystem::OnPostTickFlush);
+
+	FParse::Value(FCommandLine::Get(), TEXT("AuraSoakDuration="), Duration);
+
+	StartTime = LastSampleTime = FPlatformTime::Seconds();
+}
+
+void UAuraSoakStatsSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	GetWorld()->TickFlushEvent.Remove(TickFlushHandle);
+	GetWorld()->PostTickFlushEvent.Remove(PostTickFlushHandle);
+
+	UNetDriver* NetDriver = BoundNetDriver.Get();
+	if (NetDriver && bCountingRPCs)
+	{
+		NetDriver->SendRPCDel.Unbind();
+	}
+
+	WriteRPCSummary();
+	SampleFile.Reset();
+	ConnectionFile.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAuraSoakStatsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// The net driver only exists once the server is listening or the client has connected
+	if (!BoundNetDriver.IsValid())
+	{
+		BindRPCCounter();
+	}
+
+	const double FrameMs = DeltaTime * 1000.0;
+	++SampleFrames;
+	SampleFrameMs += FrameMs;
+	MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+	SampleGameThreadMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastSampleTime >= CVarAuraSoakSampleSeconds.GetValueOnGameThread())
+	{
+		WriteSample(Now);
+	}
+
+	if (Duration > 0.f && Now - StartTime >= Duration && !IsEngineExitRequested())
+	{
+		UE_LOG(LogAura, Display, TEXT("Soak duration of %.0f seconds reached, exiting"), Duration);
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+TStatId UAuraSoakStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraSoakStatsSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraSoakStatsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraSoakStatsSubsystem::WriteSample(double Now)
+{
+	const double SampleSeconds = Now - LastSampleTime;
+	const double Time = Now - StartTime;
+	LastSampleTime = Now;
+
+	TArray<UNetConnection*> Connections;
+	if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+	{
+		Connections.Append(NetDriver->ClientConnections);
+		if (NetDriver->ServerConnection) Connections.Add(NetDriver->ServerConnection);
+	}
+
+	int64 OutBytesPerSecond = 0;
+	int64 InBytesPerSecond = 0;
+	for (int32 Index = 0; Index < Connections.Num(); ++Index)
+	{
+		const UNetConnection* Connection = Connections[Index];
+		OutBytesPerSecond += Connection->OutBytesPerSecond;
+		InBytesPerSecond += Connection->InBytesPerSecond;
+
+		const APlayerState* PlayerState = Connection->PlayerController ? Connection->PlayerController->PlayerState : nullptr;
+		AuraSoakStats::WriteLine(ConnectionFile.Get(), FString::Printf(TEXT("%.2f,%d,%s,%d,%d,%.1f"), Time, Index,
+			PlayerState ? *PlayerState->GetPlayerName() : TEXT(""), Connection->OutBytesPerSecond, Connection->InBytesPerSecond, Connection->AvgLag * 1000.0));
+	}
+
+	const int32 NumFrames = FMath::Max(SampleFrames, 1);
+	AuraSoakStats::WriteLine(SampleFile.Get(), FString::Printf(TEXT("%.2f,%d,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%lld,%.1f,%d,%.3f,%d,%d,%llu"),
+		Time,
+		Connections.Num(),
+		SampleFrameMs / NumFrames,
+		MaxFrameMs,
+		SampleGameThreadMs / NumFrames,
+		SampleReplicationMs / NumFrames,
+		OutBytesPerSecond,
+		InBytesPerSecond,
+		Connections.Num() > 0 ? OutBytesPerSecond / Connections.Num() : 0,
+		SampleSeconds > 0.0 ? SampleRPCs / SampleSeconds : 0.0,
+		SampleGCs,
+		SampleGCMs,
+		GUObjectArray.GetObjectArrayNumMinusAvailable(),
+		GetWorld()->GetActorCount(),
+		static_cast<uint64>(FPlatformMemory::GetStats().UsedPhysical / (1024 * 1024))));
+
+	SampleFrames = 0;
+	SampleFrameMs = 0.0;
+	MaxFrameMs = 0.0;
+	SampleGameThreadMs = 0.0;
+	SampleReplicationMs = 0.0;
+	SampleGCs = 0;
+	SampleGCMs = 0.0;
+	SampleRPCs = 0;
+
+	// Flushed every sample so a killed process still leaves usable files
+	if (SampleFile.IsValid()) SampleFile->Flush();
+	if (ConnectionFile.IsValid()) ConnectionFile->Flush();
+}
+
+void UAuraSoakStatsSubsystem::WriteRPCSummary()
+{
+	TUniquePtr<FArchive> RPCFile(IFileManager::Get().CreateFileWriter(*(CsvBaseFilename + TEXT("_RPCs.csv"))));
+	if (!RPCFile.IsValid()) return;
+
+	RPCCounts.ValueSort(TGreater<int64>());
+
+	const double Seconds = FMath::Max(FPlatformTime::Seconds() - StartTime, 1.0);
+	AuraSoakStats::WriteLine(RPCFile.Get(), TEXT("Function,Count,PerSecond"));
+	for (const TPair<FName, int64>& Pair : RPCCounts)
+	{
+		AuraSoakStats::WriteLine(RPCFile.Get(), FString::Printf(TEXT("%s,%lld,%.2f"), *Pair.Key.ToString(), Pair.Value, Pair.Value / Seconds));
+	}
+}
+
+void UAuraSoakStatsSubsystem::BindRPCCounter()
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (NetDriver == nullptr) return;
+
+	BoundNetDriver = NetDriver;
+	if (NetDriver->SendRPCDel.IsBound())
+	{
+		UE_LOG(LogAura, Warning, TEXT("The net driver's SendRPCDel is already bound, RPCs will not be counted"));
+		return;
+	}
+	NetDriver->SendRPCDel.BindUObject(this, &UAuraSoakStatsSubsystem::OnSendRPC);
+	bCountingRPCs = true;
+}
+
+void UAuraSoakStatsSubsystem::OnSendRPC(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject, bool& bBlockSendRPC)
+{
+	++RPCCounts.FindOrAdd(Function->GetFName());
+	++SampleRPCs;
+}
+
+void UAuraSoakStatsSubsystem::OnPreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void UAuraSoakStatsSubsystem::OnPostGarbageCollect()
+{
+	++SampleGCs;
+	SampleGCMs += (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+}
+
+void UAuraSoakStatsSubsystem::OnTickFlush(float DeltaSeconds)
+{
+	TickFlushStartTime = FPlatformTime::Seconds();
+}
+
+void UAuraSoakStatsSubsystem::OnPostTickFlush()
+{
+	SampleReplicationMs += (FPlatformTime::Seconds() - TickFlushStartTime) * 1000.0;
+}
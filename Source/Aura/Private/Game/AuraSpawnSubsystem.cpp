@@ -0,0 +1,315 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraSpawnSubsystem.h"
+#include "Character/AuraEnemy.h"
+#include "Actor/AuraEffectActor.h"
+#include "Actor/AuraPickupManager.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerStart.h"
+#include "EngineUtils.h"
+#include "Aura/AuraLogChannels.h"
+
+static TAutoConsoleVariable<float> CVarAuraSpawnBudgetMs(
+	TEXT("Aura.Spawn.BudgetMs"),
+	2.f,
+	TEXT("Milliseconds per frame the spawner may spend spawning, initialising and pre-warming enemies. At least one item is processed per frame."));
+
+static FAutoConsoleCommandWithWorld CmdAuraSpawnDumpLatency(
+	TEXT("Aura.Spawn.DumpLatency"),
+	TEXT("Logs the enemy spawn latency histogram."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UAuraSpawnSubsystem* SpawnSubsystem = World ? World->GetSubsystem<UAuraSpawnSubsystem>() : nullptr)
+		{
+			SpawnSubsystem->DumpLatencyHistogram();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdAuraSpawnEnemies(
+	TEXT("Aura.Spawn.Enemies"),
+	TEXT("Aura.Spawn.Enemies <EnemyClassPath> <Count> [Radius=5000] [Level=1]: queues Count enemies spread over a disc around the first player start, for load tests."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UAuraSpawnSubsystem* SpawnSubsystem = World ? World->GetSubsystem<UAuraSpawnSubsystem>() : nullptr;
+		if (SpawnSubsystem == nullptr || World->GetNetMode() == NM_Client || Args.Num() < 2) return;
+
+		const TSubclassOf<AAuraEnemy> EnemyClass = LoadClass<AAuraEnemy>(nullptr, *Args[0]);
+		if (EnemyClass == nullptr)
+		{
+			UE_LOG(LogAura, Warning, TEXT("Aura.Spawn.Enemies: %s is not an enemy class"), *Args[0]);
+			return;
+		}
+
+		SpawnSubsystem->QueueCrowd(EnemyClass, FCString::Atoi(*Args[1]), Args.Num() > 2 ? FCString::Atof(*Args[2]) : 5000.f, Args.Num() > 3 ? FCString::Atoi(*Args[3]) : 1);
+	}));
+
+// Pre-warmed enemies wait here, hidden and without collision
+static const FVector PrewarmLocation(0.f, 0.f, -100000.f);
+
+void UAuraSpawnSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	SpawnLatencyHistogram.InitLinear(0.0, 1.0, 0.02);
+}
+
+void UAuraSpawnSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Load test crowd from the command line, see Scripts/aura_soak.py --enemies
+	FString EnemyClassPath;
+	int32 Count = 0;
+	if (InWorld.GetNetMode() != NM_Client && FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnEnemies="), Count) && FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnEnemyClass="), EnemyClassPath))
+	{
+		float Radius = 5000.f;
+		FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnRadius="), Radius);
+		QueueCrowd(LoadClass<AAuraEnemy>(nullptr, *EnemyClassPath), Count, Radius, 1);
+	}
+
+	FString PickupClassPath;
+	if (InWorld.GetNetMode() != NM_Client && FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnPickups="), Count) && FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnPickupClass="), PickupClassPath))
+	{
+		float Spacing = 300.f;
+		FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnPickupSpacing="), Spacing);
+		SpawnPickupField(LoadClass<AAuraEffectActor>(nullptr, *PickupClassPath), Count, Spacing);
+	}
+
+	// The same field as records of the first pickup manager's first type, see Scripts/aura_soak.py --instanced-pickups
+	if (InWorld.GetNetMode() != NM_Client && FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnInstancedPickups="), Count))
+	{
+		float Spacing = 300.f;
+		FParse::Value(FCommandLine::Get(), TEXT("AuraSpawnPickupSpacing="), Spacing);
+		TActorIterator<AAuraPickupManager> It(&InWorld);
+		if (It)
+		{
+			AddInstancedPickupField(*It, Count, Spacing);
+		}
+		else
+		{
+			UE_LOG(LogAura, Warning, TEXT("-AuraSpawnInstancedPickups needs an AuraPickupManager in the map"));
+		}
+	}
+}
+
+void UAuraSpawnSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (GetWorld()->GetNetMode() == NM_Client) return;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = CVarAuraSpawnBudgetMs.GetValueOnGameThread() / 1000.0;
+	int32 NumProcessed = 0;
+	auto HasBudget = [&]() { return NumProcessed == 0 || FPlatformTime::Seconds() - StartTime < Budget; };
+
+	// Finish enemies that already exist first so they become active as soon as possible
+	while (PendingInits.Num() > 0 && HasBudget())
+	{
+		const FAuraPendingInit PendingInit = PendingInits[0];
+		PendingInits.RemoveAt(0, 1, false);
+		++NumProcessed;
+
+		if (!IsValid(PendingInit.Enemy)) continue;
+
+		PendingInit.Enemy->FinishStartupInitialisation();
+		SetEnemyActive(PendingInit.Enemy, true);
+		SpawnLatencyHistogram.AddMeasurement(FPlatformTime::Seconds() - PendingInit.QueueTime);
+		OnEnemySpawned.Broadcast(PendingInit.Enemy);
+	}
+
+	while (PendingSpawns.Num() > 0 && HasBudget())
+	{
+		const FAuraSpawnRequest Request = PendingSpawns[0];
+		PendingSpawns.RemoveAt(0, 1, false);
+		++NumProcessed;
+
+		AAuraEnemy* Enemy = TakePrewarmed(Request.EnemyClass, Request.Transform, Request.Level);
+		if (Enemy == nullptr)
+		{
+			Enemy = SpawnEnemy(Request.EnemyClass, Request.Transform, Request.Level, false);
+		}
+		if (Enemy)
+		{
+			FAuraPendingInit& PendingInit = PendingInits.AddDefaulted_GetRef();
+			PendingInit.Enemy = Enemy;
+			PendingInit.QueueTime = Request.QueueTime;
+		}
+	}
+
+	// Quiet frame, use what is left of the budget to pre-warm
+	if (PendingSpawns.Num() == 0 && PendingInits.Num() == 0)
+	{
+		while (FPlatformTime::Seconds() - StartTime < Budget && PrewarmOne())
+		{
+		}
+	}
+}
+
+TStatId UAuraSpawnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraSpawnSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraSpawnSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraSpawnSubsystem::QueueSpawn(TSubclassOf<AAuraEnemy> EnemyClass, const FTransform& Transform, int32 Level)
+{
+	if (EnemyClass == nullptr) return;
+
+	FAuraSpawnRequest& Request = PendingSpawns.AddDefaulted_GetRef();
+	Request.EnemyClass = EnemyClass;
+	Request.Transform = Transform;
+	Request.Level = Level;
+	Request.QueueTime = FPlatformTime::Seconds();
+}
+
+void UAuraSpawnSubsystem::QueueCrowd(TSubclassOf<AAuraEnemy> EnemyClass, int32 Count, float Radius, int32 Level)
+{
+	if (EnemyClass == nullptr || Count <= 0) return;
+
+	FVector Center = FVector::ZeroVector;
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		Center = It->GetActorLocation();
+		break;
+	}
+
+	// Sunflower spiral, evenly spread and the same every run
+	const float GoldenAngle = UE_PI * (3.f - FMath::Sqrt(5.f));
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const float Distance = Radius * FMath::Sqrt((Index + 0.5f) / Count);
+		const float Angle = Index * GoldenAngle;
+		const FVector Location = Center + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.f);
+		QueueSpawn(EnemyClass, FTransform(FRotator(0.f, FMath::RadiansToDegrees(Angle), 0.f), Location), Level);
+	}
+}
+
+void UAuraSpawnSubsystem::SpawnPickupField(TSubclassOf<AAuraEffectActor> PickupClass, int32 Count, float Spacing)
+{
+	if (PickupClass == nullptr || Count <= 0) return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ForEachFieldLocation(Count, Spacing, [this, PickupClass, &SpawnParams](const FVector& Location)
+	{
+		GetWorld()->SpawnActor<AAuraEffectActor>(PickupClass, Location, FRotator::ZeroRotator, SpawnParams);
+	});
+	UE_LOG(LogAura, Display, TEXT("Spawned %d %s"), Count, *PickupClass->GetName());
+}
+
+void UAuraSpawnSubsystem::AddInstancedPickupField(AAuraPickupManager* PickupManager, int32 Count, float Spacing)
+{
+	if (PickupManager == nullptr || PickupManager->GetNumTypes() == 0 || Count <= 0) return;
+
+	// One batch for the whole field, clients lay out the grid themselves
+	int32 Columns = 0;
+	const FVector Corner = GetFieldCorner(Count, Spacing, Columns);
+	PickupManager->AddPickupGrid(0, Corner, Columns, Count, Spacing);
+	UE_LOG(LogAura, Display, TEXT("Added %d instanced pickups to %s"), Count, *PickupManager->GetName());
+}
+
+FVector UAuraSpawnSubsystem::GetFieldCorner(int32 Count, float Spacing, int32& OutColumns) const
+{
+	FVector Center = FVector::ZeroVector;
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		Center = It->GetActorLocation();
+		break;
+	}
+
+	OutColumns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	return Center - FVector(OutColumns * Spacing * 0.5f, OutColumns * Spacing * 0.5f, 0.f);
+}
+
+void UAuraSpawnSubsystem::ForEachFieldLocation(int32 Count, float Spacing, TFunctionRef<void(const FVector&)> Callback) const
+{
+	int32 Columns = 0;
+	const FVector Corner = GetFieldCorner(Count, Spacing, Columns);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Callback(Corner + FVector((Index % Columns) * Spacing, (Index / Columns) * Spacing, 0.f));
+	}
+}
+
+void UAuraSpawnSubsystem::RequestPrewarm(TSubclassOf<AAuraEnemy> EnemyClass, int32 Count)
+{
+	if (EnemyClass == nullptr) return;
+	Prewarmed.FindOrAdd(EnemyClass).TargetCount = FMath::Max(Count, 0);
+}
+
+AAuraEnemy* UAuraSpawnSubsystem::SpawnEnemy(TSubclassOf<AAuraEnemy> EnemyClass, const FTransform& Transform, int32 Level, bool bPrewarm) const
+{
+	AAuraEnemy* Enemy = GetWorld()->SpawnActorDeferred<AAuraEnemy>(EnemyClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (Enemy == nullptr) return nullptr;
+
+	Enemy->bDeferStartupInitialisation = true;
+	Enemy->SetLevel(Level);
+
+	// The controller is spawned once its attributes are in, so no behaviour tree runs while it waits
+	Enemy->AutoPossessAI = EAutoPossessAI::Disabled;
+	Enemy->FinishSpawning(Transform);
+	SetEnemyActive(Enemy, false);
+	return Enemy;
+}
+
+void UAuraSpawnSubsystem::SetEnemyActive(AAuraEnemy* Enemy, bool bActive)
+{
+	// Until its default attributes are applied an enemy has no health, so it is kept out of sight, collision and damage
+	Enemy->SetActorHiddenInGame(!bActive);
+	Enemy->SetActorEnableCollision(bActive);
+	Enemy->SetCanBeDamaged(bActive);
+	if (bActive)
+	{
+		Enemy->GetCharacterMovement()->Activate();
+		Enemy->SpawnDefaultController();
+	}
+	else
+	{
+		Enemy->GetCharacterMovement()->Deactivate();
+	}
+}
+
+AAuraEnemy* UAuraSpawnSubsystem::TakePrewarmed(TSubclassOf<AAuraEnemy> EnemyClass, const FTransform& Transform, int32 Level)
+{
+	FAuraPrewarmedEnemies* PrewarmedEnemies = Prewarmed.Find(EnemyClass);
+	if (PrewarmedEnemies == nullptr) return nullptr;
+
+	while (PrewarmedEnemies->Enemies.Num() > 0)
+	{
+		AAuraEnemy* Enemy = PrewarmedEnemies->Enemies.Pop(false);
+		if (!IsValid(Enemy)) continue;
+
+		// Stays inactive until the init queue reaches it
+		Enemy->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+		Enemy->SetLevel(Level);
+		return Enemy;
+	}
+	return nullptr;
+}
+
+bool UAuraSpawnSubsystem::PrewarmOne()
+{
+	for (TPair<TSubclassOf<AAuraEnemy>, FAuraPrewarmedEnemies>& Pair : Prewarmed)
+	{
+		if (Pair.Value.Enemies.Num() >= Pair.Value.TargetCount) continue;
+
+		if (AAuraEnemy* Enemy = SpawnEnemy(Pair.Key, FTransform(PrewarmLocation), 1, true))
+		{
+			Pair.Value.Enemies.Add(Enemy);
+			return true;
+		}
+	}
+	return false;
+}
+
+void UAuraSpawnSubsystem::DumpLatencyHistogram() const
+{
+	UE_LOG(LogAura, Log, TEXT("Enemy spawn latency (seconds), %d samples, average %.4f"), SpawnLatencyHistogram.GetNumMeasurements(), SpawnLatencyHistogram.GetAverageOfAllMeasures());
+	SpawnLatencyHistogram.DumpToLog(TEXT("Aura.Spawn.Latency"));
+}
@@ -0,0 +1,186 @@
+// Copyright Adam Thomas
+
+
+#include "Game/AuraVFXSubsystem.h"
+#include "AbilitySystemComponent.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "Kismet/GameplayStatics.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Aura/AuraStats.h"
+#include "Aura/Aura.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFX Impacts Spawned"), STAT_AuraVFXSpawned, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFX Impacts Culled"), STAT_AuraVFXCulled, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFX Impacts Over Budget"), STAT_AuraVFXOverBudget, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFX Pooled Debuff Visuals"), STAT_AuraVFXPooledDebuffs, STATGROUP_Aura);
+
+static TAutoConsoleVariable<int32> CVarAuraVFXMaxSpawnsPerFrame(
+	TEXT("Aura.VFX.MaxSpawnsPerFrame"),
+	16,
+	TEXT("Maximum number of impact effects spawned per frame, the rest are dropped."));
+
+static TAutoConsoleVariable<float> CVarAuraVFXCullDistance(
+	TEXT("Aura.VFX.CullDistance"),
+	5000.f,
+	TEXT("Impact effects further than this from the local camera are not spawned. 0 disables culling."));
+
+void UAuraVFXSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SpawnsThisFrame = 0;
+
+	for (auto It = DebuffVisuals.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid()) It.RemoveCurrent();
+	}
+}
+
+TStatId UAuraVFXSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraVFXSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraVFXSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WITH_AURA_COSMETICS && (WorldType == EWorldType::Game || WorldType == EWorldType::PIE);
+}
+
+UNiagaraComponent* UAuraVFXSubsystem::SpawnImpactEffect(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation)
+{
+	if (System == nullptr || GetWorld()->GetNetMode() == NM_DedicatedServer) return nullptr;
+
+	if (SpawnsThisFrame >= CVarAuraVFXMaxSpawnsPerFrame.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_AuraVFXOverBudget);
+		return nullptr;
+	}
+
+	if (IsCulled(Location))
+	{
+		INC_DWORD_STAT(STAT_AuraVFXCulled);
+		return nullptr;
+	}
+
+	++SpawnsThisFrame;
+	INC_DWORD_STAT(STAT_AuraVFXSpawned);
+	return UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, System, Location, Rotation, FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
+}
+
+bool UAuraVFXSubsystem::IsCulled(const FVector& Location) const
+{
+	const float CullDistance = CVarAuraVFXCullDistance.GetValueOnGameThread();
+	if (CullDistance <= 0.f) return false;
+
+	const APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (CameraManager == nullptr) return false;
+
+	return FVector::DistSquared(CameraManager->GetCameraLocation(), Location) > FMath::Square(CullDistance);
+}
+
+void UAuraVFXSubsystem::RegisterDebuffVisuals(AActor* Owner, UAbilitySystemComponent* ASC, const TMap<FGameplayTag, TObjectPtr<UNiagaraSystem>>& DebuffEffects)
+{
+	if (!IsValid(Owner) || !IsValid(ASC) || GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+	FAuraDebuffVisuals& Visuals = DebuffVisuals.FindOrAdd(Owner);
+	Visuals.ASC = ASC;
+	for (const TPair<FGameplayTag, TObjectPtr<UNiagaraSystem>>& Pair : DebuffEffects)
+	{
+		if (!Pair.Key.IsValid() || Pair.Value == nullptr || Visuals.Systems.Contains(Pair.Key)) continue;
+
+		Visuals.Systems.Add(Pair.Key, Pair.Value.Get());
+		const FDelegateHandle Handle = ASC->RegisterGameplayTagEvent(Pair.Key, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &UAuraVFXSubsystem::DebuffTagChanged, TWeakObjectPtr<AActor>(Owner));
+		Visuals.TagEventHandles.Add(Pair.Key, Handle);
+	}
+}
+
+void UAuraVFXSubsystem::ClearDebuffVisuals(AActor* Owner)
+{
+	FAuraDebuffVisuals* Visuals = DebuffVisuals.Find(Owner);
+	if (Visuals == nullptr) return;
+
+	for (const TPair<FGameplayTag, TWeakObjectPtr<UNiagaraComponent>>& Pair : Visuals->ActiveComponents)
+	{
+		if (UNiagaraComponent* Component = Pair.Value.Get())
+		{
+			Component->SetPaused(false);
+			Component->SetVisibility(true);
+			Component->Deactivate();
+			Component->ReleaseToPool();
+			DEC_DWORD_STAT(STAT_AuraVFXPooledDebuffs);
+		}
+	}
+	Visuals->ActiveComponents.Reset();
+}
+
+void UAuraVFXSubsystem::UnregisterDebuffVisuals(AActor* Owner)
+{
+	ClearDebuffVisuals(Owner);
+
+	FAuraDebuffVisuals Visuals;
+	if (!DebuffVisuals.RemoveAndCopyValue(Owner, Visuals)) return;
+
+	if (UAbilitySystemComponent* ASC = Visuals.ASC.Get())
+	{
+		for (const TPair<FGameplayTag, FDelegateHandle>& Pair : Visuals.TagEventHandles)
+		{
+			ASC->RegisterGameplayTagEvent(Pair.Key, EGameplayTagEventType::NewOrRemoved).Remove(Pair.Value);
+		}
+	}
+}
+
+void UAuraVFXSubsystem::SetDebuffVisualsSuppressed(AActor* Owner, bool bSuppressed)
+{
+	FAuraDebuffVisuals* Visuals = DebuffVisuals.Find(Owner);
+	if (Visuals == nullptr || Visuals->bSuppressed == bSuppressed) return;
+
+	Visuals->bSuppressed = bSuppressed;
+	for (const TPair<FGameplayTag, TWeakObjectPtr<UNiagaraComponent>>& Pair : Visuals->ActiveComponents)
+	{
+		if (UNiagaraComponent* Component = Pair.Value.Get())
+		{
+			Component->SetPaused(bSuppressed);
+			Component->SetVisibility(!bSuppressed);
+		}
+	}
+}
+
+void UAuraVFXSubsystem::DebuffTagChanged(const FGameplayTag CallbackTag, int32 NewCount, TWeakObjectPtr<AActor> Owner)
+{
+	FAuraDebuffVisuals* Visuals = DebuffVisuals.Find(Owner);
+	if (Visuals == nullptr) return;
+
+	AActor* OwnerActor = Owner.Get();
+	if (OwnerActor == nullptr)
+	{
+		DebuffVisuals.Remove(Owner);
+		return;
+	}
+
+	TWeakObjectPtr<UNiagaraComponent>& ActiveComponent = Visuals->ActiveComponents.FindOrAdd(CallbackTag);
+
+	if (NewCount > 0)
+	{
+		UNiagaraSystem* System = Visuals->Systems.FindRef(CallbackTag).Get();
+		if (System == nullptr || ActiveComponent.IsValid()) return;
+
+		ActiveComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(System, OwnerActor->GetRootComponent(), NAME_None, FVector::ZeroVector, FRotator::ZeroRotator,
+			EAttachLocation::KeepRelativeOffset, false, true, ENCPoolMethod::ManualRelease);
+		INC_DWORD_STAT(STAT_AuraVFXPooledDebuffs);
+
+		if (Visuals->bSuppressed && ActiveComponent.IsValid())
+		{
+			ActiveComponent->SetPaused(true);
+			ActiveComponent->SetVisibility(false);
+		}
+	}
+	else if (UNiagaraComponent* Component = ActiveComponent.Get())
+	{
+		Component->SetPaused(false);
+		Component->SetVisibility(true);
+		Component->Deactivate();
+		Component->ReleaseToPool();
+		ActiveComponent.Reset();
+		DEC_DWORD_STAT(STAT_AuraVFXPooledDebuffs);
+	}
+}
@@ -0,0 +1,199 @@
+// Copyright Adam Thomas
+
+
+#include "Player/AuraBotSubsystem.h"
+#include "Player/AuraPlayerController.h"
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "AbilitySystemBlueprintLibrary.h"
+#include "AuraGameplayTags.h"
+#include "Character/AuraEnemy.h"
+#include "Interaction/CombatInterface.h"
+#include "EngineUtils.h"
+#include "NavigationSystem.h"
+#include "Aura/AuraLogChannels.h"
+
+static TAutoConsoleVariable<float> CVarAuraBotActionInterval(
+	TEXT("Aura.Bot.ActionInterval"),
+	1.5f,
+	TEXT("Average seconds between the actions of a -AuraBot client."));
+
+static TAutoConsoleVariable<float> CVarAuraBotMoveRadius(
+	TEXT("Aura.Bot.MoveRadius"),
+	1500.f,
+	TEXT("Radius around the pawn a -AuraBot client picks click-to-move destinations in."));
+
+static TAutoConsoleVariable<float> CVarAuraBotCastRange(
+	TEXT("Aura.Bot.CastRange"),
+	2000.f,
+	TEXT("Enemies further than this are not targeted by a -AuraBot client."));
+
+bool UAuraBotSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("AuraBot"));
+}
+
+void UAuraBotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	int32 Seed = FPlatformProcess::GetCurrentProcessId();
+	FParse::Value(FCommandLine::Get(), TEXT("AuraBotSeed="), Seed);
+	RandomStream.Initialize(Seed);
+	TimeUntilNextAction = RandomStream.FRandRange(0.f, CVarAuraBotActionInterval.GetValueOnGameThread());
+
+	UE_LOG(LogAura, Log, TEXT("Bot mode, seed %d"), Seed);
+}
+
+void UAuraBotSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	AAuraPlayerController* PC = Cast<AAuraPlayerController>(GetWorld()->GetFirstPlayerController());
+	if (PC == nullptr || !PC->IsLocalController() || PC->GetPawn() == nullptr) return;
+
+	UAuraAbilitySystemComponent* ASC = Cast<UAuraAbilitySystemComponent>(UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(PC->GetPawn()));
+	if (ASC == nullptr) return;
+
+	if (PendingClickInputTag.IsValid())
+	{
+		PC->SimulateAbilityInputClick(PendingClickInputTag);
+		PendingClickInputTag = FGameplayTag();
+		return;
+	}
+
+	TimeUntilNextAction -= DeltaTime;
+	if (TimeUntilNextAction > 0.f) return;
+	TimeUntilNextAction = CVarAuraBotActionInterval.GetValueOnGameThread() * RandomStream.FRandRange(0.5f, 1.5f);
+
+	// Mostly moving and casting, like a player, with the occasional trip to the spell and attribute menus
+	const float Action = RandomStream.FRand();
+	if (Action < 0.45f)
+	{
+		MoveRandomly(PC);
+	}
+	else if (Action < 0.85f)
+	{
+		CastFireBolt(PC, ASC);
+	}
+	else if (Action < 0.95f)
+	{
+		EquipSpell(ASC);
+	}
+	else
+	{
+		UpgradeAttribute(ASC);
+	}
+}
+
+TStatId UAuraBotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraBotSubsystem, STATGROUP_Tickables);
+}
+
+bool UAuraBotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraBotSubsystem::MoveRandomly(AAuraPlayerController* PC)
+{
+	const FVector Origin = PC->GetPawn()->GetActorLocation();
+	const float Radius = CVarAuraBotMoveRadius.GetValueOnGameThread();
+
+	FVector Destination = Origin + FVector(RandomStream.GetUnitVector().GetSafeNormal2D() * RandomStream.FRandRange(0.f, Radius));
+	if (const UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		FNavLocation NavLocation;
+		if (NavSystem->GetRandomReachablePointInRadius(Origin, Radius, NavLocation))
+		{
+			Destination = NavLocation.Location;
+		}
+	}
+
+	FHitResult HitResult;
+	HitResult.bBlockingHit = true;
+	HitResult.Location = HitResult.ImpactPoint = Destination;
+	HitResult.Normal = HitResult.ImpactNormal = FVector::UpVector;
+
+	PC->SetCursorHitOverride(HitResult);
+	PendingClickInputTag = FAuraGameplayTags::Get().InputTag_LMB;
+}
+
+void UAuraBotSubsystem::CastFireBolt(AAuraPlayerController* PC, UAuraAbilitySystemComponent* ASC)
+{
+	const FGameplayTag InputTag = ASC->GetInputTagFromAbilityTag(FAuraGameplayTags::Get().Abilities_Fire_FireBolt);
+	if (!InputTag.IsValid()) return;
+
+	const FVector Origin = PC->GetPawn()->GetActorLocation();
+	AAuraEnemy* Target = nullptr;
+	float TargetDistanceSquared = FMath::Square(CVarAuraBotCastRange.GetValueOnGameThread());
+	for (TActorIterator<AAuraEnemy> It(GetWorld()); It; ++It)
+	{
+		if (ICombatInterface::Execute_IsDead(*It)) continue;
+
+		const float DistanceSquared = FVector::DistSquared(Origin, It->GetActorLocation());
+		if (DistanceSquared < TargetDistanceSquared)
+		{
+			Target = *It;
+			TargetDistanceSquared = DistanceSquared;
+		}
+	}
+	if (Target == nullptr) return;
+
+	FHitResult HitResult(Target, Target->GetMesh(), Target->GetActorLocation(), (Origin - Target->GetActorLocation()).GetSafeNormal());
+	HitResult.bBlockingHit = true;
+
+	PC->SetCursorHitOverride(HitResult);
+	PendingClickInputTag = InputTag;
+}
+
+void UAuraBotSubsystem::EquipSpell(UAuraAbilitySystemComponent* ASC)
+{
+	const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
+	const FGameplayTag PassiveAbilities = FGameplayTag::RequestGameplayTag(FName("Abilities.Passive"), false);
+
+	TArray<FGameplayTag> EligibleAbilities;
+	TArray<FGameplayTag> UnlockedAbilities;
+	ASC->ForEachAbility(FForEachAbility::CreateLambda([&](const FGameplayAbilitySpec& AbilitySpec)
+	{
+		const FGameplayTag AbilityTag = UAuraAbilitySystemComponent::GetAbilityTagFromSpec(AbilitySpec);
+		const FGameplayTag Status = UAuraAbilitySystemComponent::GetStatusFromSpec(AbilitySpec);
+		if (Status.MatchesTagExact(GameplayTags.Abilities_Status_Eligible))
+		{
+			EligibleAbilities.Add(AbilityTag);
+		}
+		else if (Status.MatchesTagExact(GameplayTags.Abilities_Status_Unlocked) || Status.MatchesTagExact(GameplayTags.Abilities_Status_Equipped))
+		{
+			UnlockedAbilities.Add(AbilityTag);
+		}
+	}));
+
+	if (EligibleAbilities.Num() > 0 && RandomStream.FRand() < 0.5f)
+	{
+		ASC->ServerSpendSpellPoint(EligibleAbilities[RandomStream.RandHelper(EligibleAbilities.Num())]);
+		return;
+	}
+
+	if (UnlockedAbilities.Num() == 0) return;
+
+	const FGameplayTag AbilityTag = UnlockedAbilities[RandomStream.RandHelper(UnlockedAbilities.Num())];
+	const bool bPassive = PassiveAbilities.IsValid() && AbilityTag.MatchesTag(PassiveAbilities);
+	const TArray<FGameplayTag> Slots = bPassive
+		? TArray<FGameplayTag>{ GameplayTags.InputTag_Passive_1, GameplayTags.InputTag_Passive_2 }
+		: TArray<FGameplayTag>{ GameplayTags.InputTag_LMB, GameplayTags.InputTag_RMB, GameplayTags.InputTag_1, GameplayTags.InputTag_2, GameplayTags.InputTag_3, GameplayTags.InputTag_4 };
+
+	ASC->ServerEquipAbility(AbilityTag, Slots[RandomStream.RandHelper(Slots.Num())]);
+}
+
+void UAuraBotSubsystem::UpgradeAttribute(UAuraAbilitySystemComponent* ASC)
+{
+	const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
+	const FGameplayTag Attributes[] = {
+		GameplayTags.Attributes_Primary_Strength,
+		GameplayTags.Attributes_Primary_Intelligence,
+		GameplayTags.Attributes_Primary_Resilience,
+		GameplayTags.Attributes_Primary_Vigor
+	};
+
+	ASC->UpgradeAttribute(Attributes[RandomStream.RandHelper(UE_ARRAY_COUNT(Attributes))]);
+}
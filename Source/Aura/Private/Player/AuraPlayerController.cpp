@@ -13,6 +13,8 @@
 #include "AuraGameplayTags.h"
 #include "GameFramework/Character.h"
 #include "UI/Widget/DamageTextComponent.h"
+#include "Aura/AuraStats.h"
+#include "Aura/Aura.h"
 
 AAuraPlayerController::AAuraPlayerController()
 {
@@ -30,6 +32,7 @@ void AAuraPlayerController::PlayerTick(float DeltaTime)
 
 void AAuraPlayerController::ShowDamageNumber_Implementation(float DamageAmount, ACharacter* TargetCharacter, bool bBlockedHit, bool bCriticalHit)
 {
+#if WITH_AURA_COSMETICS
 	if (IsValid(TargetCharacter) && DamageTextComponentClass && IsLocalController())
 	{
 		UDamageTextComponent* DamageText = NewObject<UDamageTextComponent>(TargetCharacter, DamageTextComponentClass);
@@ -38,11 +41,14 @@ void AAuraPlayerController::ShowDamageNumber_Implementation(float DamageAmount,
 		DamageText->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
 		DamageText->SetDamageText(DamageAmount, bBlockedHit, bCriticalHit);
 	}
+#endif
 }
 
 void AAuraPlayerController::AutoRun()
 {
 	if (!bAutoRunning) return;
+	SCOPE_CYCLE_COUNTER(STAT_AuraAutoRun);
+
 	if (APawn* ControlledPawn = GetPawn())
 	{
 		const FVector LocationOnSpline = Spline->FindLocationClosestToWorldLocation(ControlledPawn->GetActorLocation(), ESplineCoordinateSpace::World);
@@ -60,8 +66,8 @@ void AAuraPlayerController::AutoRun()
 
 void AAuraPlayerController::CursorTrace()
 {
-	
-	GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, CursorHit);
+	SCOPE_CYCLE_COUNTER(STAT_AuraCursorTrace);
+	GetCursorHitResult(CursorHit);
 
 	if (!CursorHit.bBlockingHit) return;
 
@@ -77,6 +83,29 @@ void AAuraPlayerController::CursorTrace()
 
 }
 
+void AAuraPlayerController::SetCursorHitOverride(const FHitResult& HitResult)
+{
+	CursorHitOverride = HitResult;
+	bCursorHitOverride = true;
+}
+
+void AAuraPlayerController::GetCursorHitResult(FHitResult& OutHitResult) const
+{
+	if (bCursorHitOverride)
+	{
+		OutHitResult = CursorHitOverride;
+		return;
+	}
+	GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, OutHitResult);
+}
+
+void AAuraPlayerController::SimulateAbilityInputClick(const FGameplayTag& InputTag)
+{
+	AbilityInputTagPressed(InputTag);
+	AbilityInputTagHeld(InputTag);
+	AbilityInputTagReleased(InputTag);
+}
+
 void AAuraPlayerController::AbilityInputTagPressed(FGameplayTag InputTag)
 {
 	if(InputTag.MatchesTagExact(FAuraGameplayTags::Get().InputTag_LMB))
@@ -0,0 +1,144 @@
+// Copyright Adam Thomas
+
+
+#include "Tests/AuraBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Dom/JsonObject.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+static TAutoConsoleVariable<int32> CVarAuraBenchmarkSamples(
+	TEXT("Aura.Benchmark.Samples"),
+	200,
+	TEXT("Timed samples per Aura.Benchmark test."));
+
+static TAutoConsoleVariable<int32> CVarAuraBenchmarkWarmUp(
+	TEXT("Aura.Benchmark.WarmUp"),
+	20,
+	TEXT("Untimed runs before the samples of each Aura.Benchmark test."));
+
+static TAutoConsoleVariable<float> CVarAuraBenchmarkHeadroom(
+	TEXT("Aura.Benchmark.Headroom"),
+	1.25f,
+	TEXT("How far over its recorded baseline a benchmark's median or p99 may go before the test fails."));
+
+static TAutoConsoleVariable<bool> CVarAuraBenchmarkRecordBaselines(
+	TEXT("Aura.Benchmark.RecordBaselines"),
+	false,
+	TEXT("Record this run's results as the baselines instead of checking against them."));
+
+namespace AuraBenchmark
+{
+	static FString GetBaselineDirectory()
+	{
+		FString Directory = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("Baselines");
+		FParse::Value(FCommandLine::Get(), TEXT("AuraBenchmarkBaselines="), Directory);
+		return Directory;
+	}
+
+	static bool SaveJson(const TSharedRef<FJsonObject>& Object, const FString& Filename)
+	{
+		FString Json;
+		FJsonSerializer::Serialize(Object, TJsonWriterFactory<>::Create(&Json));
+		return FFileHelper::SaveStringToFile(Json, *Filename);
+	}
+}
+
+bool FAuraBenchmark::Measure(FAutomationTestBase& Test) const
+{
+	using namespace AuraBenchmark;
+
+	const int32 NumSamples = FMath::Max(CVarAuraBenchmarkSamples.GetValueOnGameThread(), 1);
+	const int32 NumWarmUp = FMath::Max(CVarAuraBenchmarkWarmUp.GetValueOnGameThread(), 0);
+
+	for (int32 Index = 0; Index < NumWarmUp; ++Index)
+	{
+		if (Setup) Setup();
+		Run();
+	}
+
+	TArray<double> Samples;
+	Samples.Reserve(NumSamples);
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		if (Setup) Setup();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Run();
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		Samples.Add(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0 / OperationsPerSample);
+	}
+	Samples.Sort();
+
+	const double Median = Samples[NumSamples / 2];
+	const double P99 = Samples[FMath::Min(FMath::CeilToInt(NumSamples * 0.99) - 1, NumSamples - 1)];
+	double Total = 0.0;
+	for (const double Sample : Samples)
+	{
+		Total += Sample;
+	}
+
+	const FString CPUBrand = FPlatformMisc::GetCPUBrand().TrimStartAndEnd();
+	const FString BaselineFilename = GetBaselineDirectory() / Name + TEXT(".json");
+	FString BaselineJson;
+	TSharedPtr<FJsonObject> Baseline;
+	const bool bHasBaseline = !CVarAuraBenchmarkRecordBaselines.GetValueOnGameThread()
+		&& FFileHelper::LoadFileToString(BaselineJson, *BaselineFilename)
+		&& FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline) && Baseline.IsValid();
+
+	const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("Name"), Name);
+	Result->SetStringField(TEXT("CPU"), CPUBrand);
+	Result->SetNumberField(TEXT("MedianMicroseconds"), Median);
+	Result->SetNumberField(TEXT("P99Microseconds"), P99);
+	Result->SetNumberField(TEXT("MeanMicroseconds"), Total / NumSamples);
+	Result->SetNumberField(TEXT("Samples"), NumSamples);
+
+	bool bPassed = true;
+	if (!bHasBaseline)
+	{
+		const TSharedRef<FJsonObject> NewBaseline = MakeShared<FJsonObject>();
+		NewBaseline->SetStringField(TEXT("CPU"), CPUBrand);
+		NewBaseline->SetStringField(TEXT("Recorded"), FDateTime::UtcNow().ToIso8601());
+		NewBaseline->SetNumberField(TEXT("MedianMicroseconds"), Median);
+		NewBaseline->SetNumberField(TEXT("P99Microseconds"), P99);
+		SaveJson(NewBaseline, BaselineFilename);
+		Test.AddInfo(FString::Printf(TEXT("%s: median %.3f us, p99 %.3f us, recorded as the baseline in %s"), *Name, Median, P99, *BaselineFilename));
+	}
+	else if (Baseline->GetStringField(TEXT("CPU")) != CPUBrand)
+	{
+		// Another machine's timings say nothing about this one
+		Test.AddWarning(FString::Printf(TEXT("%s: median %.3f us, p99 %.3f us, not checked as the baseline was recorded on %s. Set Aura.Benchmark.RecordBaselines to record one here"),
+			*Name, Median, P99, *Baseline->GetStringField(TEXT("CPU"))));
+	}
+	else
+	{
+		const double Headroom = CVarAuraBenchmarkHeadroom.GetValueOnGameThread();
+		const double BudgetMedian = Baseline->GetNumberField(TEXT("MedianMicroseconds")) * Headroom;
+		const double BudgetP99 = Baseline->GetNumberField(TEXT("P99Microseconds")) * Headroom;
+		Result->SetNumberField(TEXT("BudgetMedianMicroseconds"), BudgetMedian);
+		Result->SetNumberField(TEXT("BudgetP99Microseconds"), BudgetP99);
+
+		bPassed = Median <= BudgetMedian && P99 <= BudgetP99;
+		const FString Message = FString::Printf(TEXT("%s: median %.3f us (budget %.3f), p99 %.3f us (budget %.3f)"), *Name, Median, BudgetMedian, P99, BudgetP99);
+		if (bPassed)
+		{
+			Test.AddInfo(Message);
+		}
+		else
+		{
+			Test.AddError(Message + TEXT(", over the baseline"));
+		}
+	}
+
+	Result->SetBoolField(TEXT("Passed"), bPassed);
+	SaveJson(Result, FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("Results") / Name + TEXT(".json"));
+	return bPassed;
+}
+
+#endif
@@ -0,0 +1,33 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FAutomationTestBase;
+
+/**
+ * One timed operation for the Aura.Benchmark automation tests, which report its median and p99 after a warm-up.
+ * UnrealEditor-Cmd Aura.uproject -nullrhi -unattended -ExecCmds="Automation RunTests Aura.Benchmark;Quit" [-AuraBenchmarkBaselines=<Dir>]
+ * Results are written to Saved/Benchmarks/Results/<Name>.json. Budgets come from the baseline measured on the machine running the
+ * tests, Saved/Benchmarks/Baselines/<Name>.json unless -AuraBenchmarkBaselines points CI at a kept directory. The first run, or any
+ * run with Aura.Benchmark.RecordBaselines, records it. A median or p99 over the baseline times Aura.Benchmark.Headroom fails the test.
+ */
+struct FAuraBenchmark
+{
+	FString Name;
+
+	// Run is timed as one sample and divided by this to give the time per operation
+	int32 OperationsPerSample = 1;
+	TFunction<void()> Run;
+
+	// Untimed, runs before every sample to put the fixtures back, e.g. to heal the targets of the previous sample
+	TFunction<void()> Setup;
+
+	/** Measures the benchmark, writes its result and reports it to Test, false if it is over its budget */
+	bool Measure(FAutomationTestBase& Test) const;
+};
+
+#endif
@@ -0,0 +1,462 @@
+// Copyright Adam Thomas
+
+
+#include "Tests/AuraBenchmark.h"
+#include "Tests/AuraTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/AuraRandomStream.h"
+#include "AbilitySystem/Abilities/AuraGameplayAbility.h"
+#include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "AbilitySystem/Data/LevelUpInfo.h"
+#include "AbilitySystem/Debuff/AuraDoTSubsystem.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "AbilitySystem/Snapshot/AuraAttributeSnapshotSubsystem.h"
+#include "Actor/AuraProjectile.h"
+#include "Character/AuraEnemy.h"
+#include "Character/AuraSignificanceSubsystem.h"
+#include "Player/AuraPlayerState.h"
+#include "UI/WidgetController/OverlayWidgetController.h"
+#include "UI/WidgetController/AttributeMenuWidgetController.h"
+#include "AuraGameplayTags.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+
+namespace AuraBenchmarkTests
+{
+	constexpr EAutomationTestFlags::Type TestFlags = static_cast<EAutomationTestFlags::Type>(EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter);
+
+	constexpr int32 KernelBatchSize = 1024;
+
+	// Keeps results observable so the optimiser cannot drop the work
+	static volatile float Sink = 0.f;
+
+	/** Random kernel inputs, laid out as the batch expects */
+	struct FKernelInputs
+	{
+		TArray<float> Inputs;
+		TArray<float> Output;
+		FAuraDamageKernel::FBatch Batch;
+
+		FKernelInputs()
+		{
+			Inputs.SetNumUninitialized(KernelBatchSize * 9);
+			Output.SetNumUninitialized(KernelBatchSize);
+			FAuraRandomStream RollStream(1);
+			for (float& Input : Inputs)
+			{
+				Input = static_cast<float>(RollStream.RandRange(1, 100));
+			}
+
+			Batch.Num = KernelBatchSize;
+			Batch.Damage = Inputs.GetData();
+			Batch.BlockRoll = Batch.Damage + KernelBatchSize;
+			Batch.CriticalHitRoll = Batch.BlockRoll + KernelBatchSize;
+			Batch.TargetBlockChance = Batch.CriticalHitRoll + KernelBatchSize;
+			Batch.TargetArmour = Batch.TargetBlockChance + KernelBatchSize;
+			Batch.SourceArmourPenetration = Batch.TargetArmour + KernelBatchSize;
+			Batch.SourceCriticalHitChance = Batch.SourceArmourPenetration + KernelBatchSize;
+			Batch.TargetCriticalHitResistance = Batch.SourceCriticalHitChance + KernelBatchSize;
+			Batch.SourceCriticalHitDamage = Batch.TargetCriticalHitResistance + KernelBatchSize;
+			Batch.ArmourPenetrationCoefficient = 0.25f;
+			Batch.EffectiveArmourCoefficient = 0.3f;
+			Batch.CriticalHitResistanceCoefficient = 0.25f;
+		}
+	};
+
+	/** A grid of 100 enemies, the first of which deals GE_Damage to the others. Native enemies carry no Enemy tag, so they can */
+	struct FCombatFixture
+	{
+		FAuraTestWorld TestWorld;
+		TArray<AAuraEnemy*> Enemies;
+		UAuraAbilitySystemComponent* SourceASC = nullptr;
+		TSubclassOf<UGameplayEffect> DamageEffectClass;
+
+		bool Init(FAutomationTestBase& Test)
+		{
+			if (!TestWorld.IsValid())
+			{
+				Test.AddError(FString::Printf(TEXT("%s has no character class info"), FAuraTestWorld::DefaultGameModePath));
+				return false;
+			}
+
+			DamageEffectClass = LoadClass<UGameplayEffect>(nullptr, TEXT("/Game/Blueprints/AbilitySystem/Aura/Effects/GE_Damage.GE_Damage_C"));
+			if (!DamageEffectClass)
+			{
+				Test.AddError(TEXT("Could not load GE_Damage"));
+				return false;
+			}
+
+			for (int32 Index = 0; Index < 100; ++Index)
+			{
+				Enemies.Add(TestWorld.SpawnEnemy(FVector((Index % 10) * 200.f, (Index / 10) * 200.f, 0.f)));
+			}
+			SourceASC = CastChecked<UAuraAbilitySystemComponent>(Enemies[0]->GetAbilitySystemComponent());
+			return true;
+		}
+
+		UWorld* GetWorld() const { return TestWorld.GetWorld(); }
+
+		FDamageEffectParams MakeDamageEffectParams(AAuraEnemy* Target, float BaseDamage) const
+		{
+			FDamageEffectParams DamageEffectParams;
+			DamageEffectParams.WorldContextObject = Enemies[0];
+			DamageEffectParams.DamageGameplayEffectClass = DamageEffectClass;
+			DamageEffectParams.SourceAbilitySystemComponent = SourceASC;
+			DamageEffectParams.TargetAbilitySystemComponent = Target ? Target->GetAbilitySystemComponent() : nullptr;
+			DamageEffectParams.BaseDamage = BaseDamage;
+			DamageEffectParams.DamageType = FAuraGameplayTags::Get().Damage_Fire;
+			return DamageEffectParams;
+		}
+
+		/** Puts every enemy back at full health and lets the hit react cooldown and the last react's montage run out */
+		void HealEnemies() const
+		{
+			TestWorld.Tick(0.5f);
+			for (AAuraEnemy* Enemy : Enemies)
+			{
+				UAbilitySystemComponent* ASC = Enemy->GetAbilitySystemComponent();
+				ASC->SetNumericAttributeBase(UAuraAttributeSet::GetHealthAttribute(), ASC->GetNumericAttribute(UAuraAttributeSet::GetMaxHealthAttribute()));
+			}
+		}
+	};
+
+	/** A player state's ability system with the overlay and attribute menu widget controllers bound to it, as the HUD does */
+	struct FWidgetControllerFixture
+	{
+		FAuraTestWorld TestWorld;
+		UAbilitySystemComponent* PlayerASC = nullptr;
+		UOverlayWidgetController* OverlayController = nullptr;
+		UAttributeMenuWidgetController* AttributeMenuController = nullptr;
+
+		bool Init(FAutomationTestBase& Test)
+		{
+			const TSubclassOf<UOverlayWidgetController> OverlayControllerClass = LoadClass<UOverlayWidgetController>(nullptr, TEXT("/Game/Blueprints/UI/WidgetController/BP_OverlayWidgetController.BP_OverlayWidgetController_C"));
+			const TSubclassOf<UAttributeMenuWidgetController> AttributeMenuControllerClass = LoadClass<UAttributeMenuWidgetController>(nullptr, TEXT("/Game/Blueprints/UI/WidgetController/BP_AttributeMenuWidgetController.BP_AttributeMenuWidgetController_C"));
+			if (!OverlayControllerClass || !AttributeMenuControllerClass)
+			{
+				Test.AddError(TEXT("Could not load the widget controller blueprints"));
+				return false;
+			}
+
+			AAuraPlayerState* PlayerState = TestWorld.GetWorld()->SpawnActor<AAuraPlayerState>();
+			PlayerASC = PlayerState->GetAbilitySystemComponent();
+			PlayerASC->InitAbilityActorInfo(PlayerState, PlayerState);
+			const FWidgetControllerParams WidgetControllerParams(nullptr, PlayerState, PlayerASC, PlayerState->GetAttributeSet());
+
+			OverlayController = NewObject<UOverlayWidgetController>(GetTransientPackage(), OverlayControllerClass);
+			OverlayController->SetWidgetControllerParams(WidgetControllerParams);
+			OverlayController->BindCallbacksToDependencies();
+
+			AttributeMenuController = NewObject<UAttributeMenuWidgetController>(GetTransientPackage(), AttributeMenuControllerClass);
+			AttributeMenuController->SetWidgetControllerParams(WidgetControllerParams);
+			AttributeMenuController->BindCallbacksToDependencies();
+			return true;
+		}
+	};
+}
+
+using namespace AuraBenchmarkTests;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkDamageKernelTest, "Aura.Benchmark.Damage.Kernel", TestFlags)
+bool FAuraBenchmarkDamageKernelTest::RunTest(const FString& Parameters)
+{
+	const FKernelInputs KernelInputs;
+	const FAuraDamageKernel::FBatch& Batch = KernelInputs.Batch;
+
+	return FAuraBenchmark{ TEXT("Damage.Kernel"), KernelBatchSize, [&]()
+	{
+		float Total = 0.f;
+		for (int32 Index = 0; Index < KernelBatchSize; ++Index)
+		{
+			float Damage = FAuraDamageKernel::ApplyResistance(Batch.Damage[Index], 10.f);
+			Damage = FAuraDamageKernel::ApplyBlock(Damage, Batch.BlockRoll[Index] < Batch.TargetBlockChance[Index]);
+			Damage = FAuraDamageKernel::ApplyArmour(Damage, Batch.TargetArmour[Index], Batch.SourceArmourPenetration[Index], Batch.ArmourPenetrationCoefficient, Batch.EffectiveArmourCoefficient);
+			const float CriticalHitChance = FAuraDamageKernel::GetEffectiveCriticalHitChance(Batch.SourceCriticalHitChance[Index], Batch.TargetCriticalHitResistance[Index], Batch.CriticalHitResistanceCoefficient);
+			Total += FAuraDamageKernel::ApplyCriticalHit(Damage, Batch.CriticalHitRoll[Index] < CriticalHitChance, Batch.SourceCriticalHitDamage[Index]);
+		}
+		Sink = Total;
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkDamageKernelBatchTest, "Aura.Benchmark.Damage.KernelBatch", TestFlags)
+bool FAuraBenchmarkDamageKernelBatchTest::RunTest(const FString& Parameters)
+{
+	FKernelInputs KernelInputs;
+
+	return FAuraBenchmark{ TEXT("Damage.KernelBatch"), KernelBatchSize, [&]()
+	{
+		FAuraDamageKernel::ComputeBatch(KernelInputs.Batch, KernelInputs.Output.GetData());
+		Sink = KernelInputs.Output[KernelBatchSize - 1];
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkDamageExecCalcTest, "Aura.Benchmark.Damage.ExecCalc", TestFlags)
+bool FAuraBenchmarkDamageExecCalcTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	// Zero damage runs the spec and the whole execution without killing or hit reacting
+	const FDamageEffectParams DamageEffectParams = Fixture.MakeDamageEffectParams(Fixture.Enemies[1], 0.f);
+	return FAuraBenchmark{ TEXT("Damage.ExecCalc"), 100, [&]()
+	{
+		for (int32 Index = 0; Index < 100; ++Index)
+		{
+			UAuraAbilitySystemLibrary::ApplyDamageEffect(DamageEffectParams);
+		}
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkDamageAoEHitReactTest, "Aura.Benchmark.Damage.AoEHitReact", TestFlags)
+bool FAuraBenchmarkDamageAoEHitReactTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	return FAuraBenchmark{ TEXT("Damage.AoEHitReact"), Fixture.Enemies.Num() - 1, [&]()
+	{
+		// One AoE hit on every enemy in the same frame, each takes damage and tries to hit react
+		for (int32 Index = 1; Index < Fixture.Enemies.Num(); ++Index)
+		{
+			UAuraAbilitySystemLibrary::ApplyDamageEffect(Fixture.MakeDamageEffectParams(Fixture.Enemies[Index], 1.f));
+		}
+	}, [&]() { Fixture.HealEnemies(); } }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkProjectileHitTest, "Aura.Benchmark.Projectile.Hit", TestFlags)
+bool FAuraBenchmarkProjectileHitTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	AAuraEnemy* Target = Fixture.Enemies[1];
+	return FAuraBenchmark{ TEXT("Projectile.Hit"), 1, [&]()
+	{
+		const FTransform Transform(Target->GetActorLocation());
+		AAuraProjectile* Projectile = Fixture.GetWorld()->SpawnActorDeferred<AAuraProjectile>(AAuraProjectile::StaticClass(), Transform);
+		Projectile->DamageEffectParams = Fixture.MakeDamageEffectParams(nullptr, 1.f);
+		Projectile->FinishSpawning(Transform);
+
+		// Delivers the overlap the sphere would report, the projectile applies its damage and destroys itself
+		USphereComponent* Sphere = Projectile->FindComponentByClass<USphereComponent>();
+		Sphere->OnComponentBeginOverlap.Broadcast(Sphere, Target, Target->GetCapsuleComponent(), 0, false, FHitResult());
+	}, [&]() { Fixture.HealEnemies(); } }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkProjectileSpawnAndDestroyTest, "Aura.Benchmark.Projectile.SpawnAndDestroy", TestFlags)
+bool FAuraBenchmarkProjectileSpawnAndDestroyTest::RunTest(const FString& Parameters)
+{
+	const FAuraTestWorld TestWorld;
+
+	return FAuraBenchmark{ TEXT("Projectile.SpawnAndDestroy"), 1, [&]()
+	{
+		AAuraProjectile* Projectile = TestWorld.GetWorld()->SpawnActor<AAuraProjectile>(AAuraProjectile::StaticClass(), FTransform(FVector(0.f, 0.f, 500.f)));
+		Projectile->Destroy();
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkSpawnApplySnapshotTest, "Aura.Benchmark.Spawn.ApplySnapshot", TestFlags)
+bool FAuraBenchmarkSpawnApplySnapshotTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	const UCharacterClassInfo* CharacterClassInfo = Fixture.TestWorld.GetCharacterClassInfo();
+	UAuraAttributeSnapshotSubsystem* SnapshotSubsystem = Fixture.TestWorld.GetGameInstance()->GetSubsystem<UAuraAttributeSnapshotSubsystem>();
+	UAbilitySystemComponent* SnapshotASC = Fixture.Enemies[1]->GetAbilitySystemComponent();
+	if (SnapshotSubsystem->GetNumSnapshots() == 0)
+	{
+		AddError(TEXT("No attribute snapshot was captured, is Aura.AttributeSnapshot disabled?"));
+		return false;
+	}
+
+	return FAuraBenchmark{ TEXT("Spawn.ApplySnapshot"), 1, [&]()
+	{
+		Sink = SnapshotSubsystem->ApplySnapshot(SnapshotASC, ECharacterClass::Warrior, 1.f, CharacterClassInfo->SecondaryAttributes) ? 1.f : 0.f;
+	}, [&]()
+	{
+		SnapshotASC->RemoveActiveGameplayEffectBySourceEffect(CharacterClassInfo->SecondaryAttributes, nullptr);
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkSpawnApplyEffectsTest, "Aura.Benchmark.Spawn.ApplyEffects", TestFlags)
+bool FAuraBenchmarkSpawnApplyEffectsTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	// The same enemy and class as Spawn.ApplySnapshot, initialised the way it would be with no snapshot
+	IConsoleVariable* SnapshotCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.AttributeSnapshot"));
+	const bool bSnapshotEnabled = SnapshotCVar->GetBool();
+	SnapshotCVar->Set(false);
+	ON_SCOPE_EXIT { SnapshotCVar->Set(bSnapshotEnabled); };
+
+	const UCharacterClassInfo* CharacterClassInfo = Fixture.TestWorld.GetCharacterClassInfo();
+	const FCharacterClassDefaultInfo& ClassDefaultInfo = CharacterClassInfo->CharacterClassInformation.FindChecked(ECharacterClass::Warrior);
+	AAuraEnemy* Enemy = Fixture.Enemies[1];
+	UAbilitySystemComponent* EnemyASC = Enemy->GetAbilitySystemComponent();
+
+	return FAuraBenchmark{ TEXT("Spawn.ApplyEffects"), 1, [&]()
+	{
+		UAuraAbilitySystemLibrary::InitializeDefaultAttributes(Enemy, ECharacterClass::Warrior, 1.f, EnemyASC);
+	}, [&]()
+	{
+		EnemyASC->RemoveActiveGameplayEffectBySourceEffect(ClassDefaultInfo.PrimaryAttributes, nullptr);
+		EnemyASC->RemoveActiveGameplayEffectBySourceEffect(CharacterClassInfo->SecondaryAttributes, nullptr);
+		EnemyASC->RemoveActiveGameplayEffectBySourceEffect(CharacterClassInfo->VitalAttributes, nullptr);
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkDebuffAddDoTTest, "Aura.Benchmark.Debuff.AddDoT", TestFlags)
+bool FAuraBenchmarkDebuffAddDoTTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	UAuraDoTSubsystem* DoTSubsystem = Fixture.GetWorld()->GetSubsystem<UAuraDoTSubsystem>();
+	const FGameplayTag& DebuffTag = FAuraGameplayTags::Get().Debuff_Burn;
+	return FAuraBenchmark{ TEXT("Debuff.AddDoT"), Fixture.Enemies.Num(), [&]()
+	{
+		for (AAuraEnemy* Enemy : Fixture.Enemies)
+		{
+			// No damage per tick, so only the bookkeeping and tag changes are measured
+			DoTSubsystem->AddDoT(Fixture.SourceASC, Enemy->GetAbilitySystemComponent(), DebuffTag, 0.f, 1.f, 5.f);
+		}
+		DoTSubsystem->Tick(0.016f);
+		for (AAuraEnemy* Enemy : Fixture.Enemies)
+		{
+			DoTSubsystem->RemoveDoTsOnTarget(Enemy->GetAbilitySystemComponent());
+		}
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkSignificanceUpdateTest, "Aura.Benchmark.Significance.Update", TestFlags)
+bool FAuraBenchmarkSignificanceUpdateTest::RunTest(const FString& Parameters)
+{
+	const FAuraTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+
+	// The 500 enemy scene, a 25 by 20 grid 9600 by 7600 units with the player's pawn in one corner
+	constexpr int32 NumEnemies = 500;
+	for (int32 Index = 0; Index < NumEnemies; ++Index)
+	{
+		TestWorld.SpawnEnemy(FVector((Index % 25) * 400.f, (Index / 25) * 400.f, 0.f));
+	}
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	APawn* Viewer = World->SpawnActor<APawn>();
+	PlayerController->Possess(Viewer);
+
+	UAuraSignificanceSubsystem* SignificanceSubsystem = World->GetSubsystem<UAuraSignificanceSubsystem>();
+	const float UpdateInterval = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.Significance.UpdateInterval"))->GetFloat();
+
+	// The viewer moves between opposite corners, so every update rescores all enemies and moves most of them to another bucket
+	bool bFarCorner = false;
+	return FAuraBenchmark{ TEXT("Significance.Update"), NumEnemies, [&]()
+	{
+		SignificanceSubsystem->Tick(UpdateInterval);
+	}, [&]()
+	{
+		bFarCorner = !bFarCorner;
+		Viewer->SetActorLocation(bFarCorner ? FVector(9600.f, 7600.f, 0.f) : FVector::ZeroVector);
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkGetSpecFromAbilityTagTest, "Aura.Benchmark.Ability.GetSpecFromAbilityTag", TestFlags)
+bool FAuraBenchmarkGetSpecFromAbilityTagTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	for (int32 Index = 0; Index < 20; ++Index)
+	{
+		Fixture.SourceASC->GiveAbility(FGameplayAbilitySpec(UAuraGameplayAbility::StaticClass(), 1));
+	}
+
+	// A tag none of the specs have, the worst case scan
+	const FGameplayTag& AbilityTag = FAuraGameplayTags::Get().Abilities_Fire_FireBolt;
+	return FAuraBenchmark{ TEXT("Ability.GetSpecFromAbilityTag"), 100, [&]()
+	{
+		for (int32 Index = 0; Index < 100; ++Index)
+		{
+			Sink = Fixture.SourceASC->GetSpecFromAbilityTag(AbilityTag) ? 1.f : 0.f;
+		}
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkFindLevelForXPTest, "Aura.Benchmark.XP.FindLevelForXP", TestFlags)
+bool FAuraBenchmarkFindLevelForXPTest::RunTest(const FString& Parameters)
+{
+	ULevelUpInfo* LevelUpInfo = NewObject<ULevelUpInfo>();
+	LevelUpInfo->LevelUpInformation.SetNum(41);
+	for (int32 Level = 1; Level < LevelUpInfo->LevelUpInformation.Num(); ++Level)
+	{
+		LevelUpInfo->LevelUpInformation[Level].LevelUpRequirement = Level * Level * 300;
+	}
+
+	return FAuraBenchmark{ TEXT("XP.FindLevelForXP"), 100, [&]()
+	{
+		int32 Total = 0;
+		for (int32 Index = 0; Index < 100; ++Index)
+		{
+			Total += LevelUpInfo->FindLevelForXP(Index * 4000);
+		}
+		Sink = static_cast<float>(Total);
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkGetLivePlayersWithinRadiusTest, "Aura.Benchmark.Targeting.GetLivePlayersWithinRadius", TestFlags)
+bool FAuraBenchmarkGetLivePlayersWithinRadiusTest::RunTest(const FString& Parameters)
+{
+	FCombatFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	return FAuraBenchmark{ TEXT("Targeting.GetLivePlayersWithinRadius"), 1, [&]()
+	{
+		TArray<AActor*> OverlappingActors;
+		UAuraAbilitySystemLibrary::GetLivePlayersWithinRadius(Fixture.GetWorld(), OverlappingActors, TArray<AActor*>(), 800.f, FVector(900.f, 900.f, 0.f));
+		Sink = static_cast<float>(OverlappingActors.Num());
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkHealthChangedTest, "Aura.Benchmark.UI.HealthChanged", TestFlags)
+bool FAuraBenchmarkHealthChangedTest::RunTest(const FString& Parameters)
+{
+	FWidgetControllerFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	return FAuraBenchmark{ TEXT("UI.HealthChanged"), 100, [&]()
+	{
+		// Each change goes through the overlay's and the attribute menu's callbacks to their delegates
+		Fixture.PlayerASC->SetNumericAttributeBase(UAuraAttributeSet::GetMaxHealthAttribute(), 100.f);
+		for (int32 Index = 0; Index < 100; ++Index)
+		{
+			Fixture.PlayerASC->SetNumericAttributeBase(UAuraAttributeSet::GetHealthAttribute(), Index % 2 ? 40.f : 60.f);
+		}
+	} }.Measure(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraBenchmarkBroadcastInitialValuesTest, "Aura.Benchmark.UI.BroadcastInitialValues", TestFlags)
+bool FAuraBenchmarkBroadcastInitialValuesTest::RunTest(const FString& Parameters)
+{
+	FWidgetControllerFixture Fixture;
+	if (!Fixture.Init(*this)) return false;
+
+	return FAuraBenchmark{ TEXT("UI.BroadcastInitialValues"), 1, [&]()
+	{
+		Fixture.OverlayController->BroadcastInitialValues();
+		Fixture.AttributeMenuController->BroadcastInitialValues();
+	} }.Measure(*this);
+}
+
+#endif
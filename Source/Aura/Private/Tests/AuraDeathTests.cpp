@@ -0,0 +1,91 @@
+// Copyright Adam Thomas
+
+
+#include "Tests/AuraTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "Character/AuraCorpseSubsystem.h"
+#include "Character/AuraEnemy.h"
+#include "AuraGameplayTags.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraDeathManyInOneFrameTest, "Aura.Death.ManyInOneFrame", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FAuraDeathManyInOneFrameTest::RunTest(const FString& Parameters)
+{
+	const FAuraTestWorld TestWorld;
+	if (!TestWorld.IsValid())
+	{
+		AddError(FString::Printf(TEXT("%s has no character class info"), FAuraTestWorld::DefaultGameModePath));
+		return false;
+	}
+
+	const TSubclassOf<UGameplayEffect> DamageEffectClass = LoadClass<UGameplayEffect>(nullptr, TEXT("/Game/Blueprints/AbilitySystem/Aura/Effects/GE_Damage.GE_Damage_C"));
+	if (!DamageEffectClass)
+	{
+		AddError(TEXT("Could not load GE_Damage"));
+		return false;
+	}
+
+	constexpr int32 NumEnemies = 200;
+	AAuraEnemy* Killer = TestWorld.SpawnEnemy(FVector(-1000.f, -1000.f, 0.f));
+	TArray<AAuraEnemy*> Enemies;
+	for (int32 Index = 0; Index < NumEnemies; ++Index)
+	{
+		Enemies.Add(TestWorld.SpawnEnemy(FVector((Index % 20) * 200.f, (Index / 20) * 200.f, 0.f)));
+	}
+
+	// Every enemy takes a lethal hit in the same frame, then a second kill as a DoT finishing that frame would give it
+	FDamageEffectParams DamageEffectParams;
+	DamageEffectParams.WorldContextObject = Killer;
+	DamageEffectParams.DamageGameplayEffectClass = DamageEffectClass;
+	DamageEffectParams.SourceAbilitySystemComponent = Killer->GetAbilitySystemComponent();
+	DamageEffectParams.BaseDamage = 100000.f;
+	DamageEffectParams.DamageType = FAuraGameplayTags::Get().Damage_Fire;
+	DamageEffectParams.DeathImpulseMagnitude = 1000.f;
+	DamageEffectParams.DeathImpulse = FVector(0.f, 0.f, 1000.f);
+	for (AAuraEnemy* Enemy : Enemies)
+	{
+		DamageEffectParams.TargetAbilitySystemComponent = Enemy->GetAbilitySystemComponent();
+		UAuraAbilitySystemLibrary::ApplyDamageEffect(DamageEffectParams);
+	}
+	for (AAuraEnemy* Enemy : Enemies)
+	{
+		Enemy->Die(FVector::ZeroVector);
+	}
+
+	TestWorld.Tick(1.f / 60.f);
+	TestWorld.Tick(1.f / 60.f);
+
+	// Corpses beyond the budget are evicted, hidden with their physics released
+	const UAuraCorpseSubsystem* CorpseSubsystem = TestWorld.GetWorld()->GetSubsystem<UAuraCorpseSubsystem>();
+	const int32 MaxCorpses = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.Corpse.MaxCorpses"))->GetInt();
+	const int32 MaxSimulating = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.Corpse.MaxSimulating"))->GetInt();
+	if (!TestNotNull(TEXT("Corpse subsystem"), CorpseSubsystem)) return false;
+
+	int32 NumNotDead = 0;
+	int32 NumLostDeaths = 0;
+	int32 NumRepeatedDeaths = 0;
+	int32 NumNotCorpses = 0;
+	for (const AAuraEnemy* Enemy : Enemies)
+	{
+		NumNotDead += Enemy->DeathState.bDead ? 0 : 1;
+		NumLostDeaths += Enemy->NumHandledDeaths == 0 ? 1 : 0;
+		NumRepeatedDeaths += Enemy->NumHandledDeaths > 1 ? 1 : 0;
+		NumNotCorpses += CorpseSubsystem->IsCorpse(Enemy) || Enemy->IsHidden() ? 0 : 1;
+	}
+
+	TestEqual(TEXT("Enemies without DeathState.bDead"), NumNotDead, 0);
+	TestEqual(TEXT("Enemies whose HandleDeath never ran"), NumLostDeaths, 0);
+	TestEqual(TEXT("Enemies whose HandleDeath ran more than once"), NumRepeatedDeaths, 0);
+	TestEqual(TEXT("Enemies neither a kept nor an evicted corpse"), NumNotCorpses, 0);
+	TestEqual(TEXT("Kept corpses"), CorpseSubsystem->GetNumCorpses(), FMath::Min(NumEnemies, MaxCorpses));
+	TestTrue(TEXT("Simulating corpses within Aura.Corpse.MaxSimulating"), CorpseSubsystem->GetNumSimulatingCorpses() <= MaxSimulating);
+	TestEqual(TEXT("The killer survives"), Killer->NumHandledDeaths, 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright Adam Thomas
+
+
+#include "Tests/AuraTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Character/AuraDissolveSubsystem.h"
+#include "Character/AuraEnemy.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraDissolveMIDBudgetTest, "Aura.Dissolve.MIDBudget", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FAuraDissolveMIDBudgetTest::RunTest(const FString& Parameters)
+{
+	const FAuraTestWorld TestWorld;
+	if (!TestWorld.IsValid())
+	{
+		AddError(FString::Printf(TEXT("%s has no character class info"), FAuraTestWorld::DefaultGameModePath));
+		return false;
+	}
+
+	// Two enemy types with a dissolve material on the mesh and on the weapon, so the pool also has to trade idle instances between parents
+	const TSubclassOf<AAuraEnemy> EnemyClasses[] =
+	{
+		LoadClass<AAuraEnemy>(nullptr, TEXT("/Game/Blueprints/Character/Goblin_Spear/BP_Goblin_Spear.BP_Goblin_Spear_C")),
+		LoadClass<AAuraEnemy>(nullptr, TEXT("/Game/Blueprints/Character/Shaman/BP_Shaman.BP_Shaman_C"))
+	};
+	if (!EnemyClasses[0] || !EnemyClasses[1])
+	{
+		AddError(TEXT("Could not load the enemy blueprints"));
+		return false;
+	}
+
+	constexpr int32 NumEnemies = 100;
+	TArray<AAuraEnemy*> Enemies;
+	for (int32 Index = 0; Index < NumEnemies; ++Index)
+	{
+		Enemies.Add(TestWorld.SpawnEnemy(FVector((Index % 10) * 200.f, (Index / 10) * 200.f, 0.f), EnemyClasses[Index % 2]));
+	}
+
+	UAuraDissolveSubsystem* DissolveSubsystem = TestWorld.GetWorld()->GetSubsystem<UAuraDissolveSubsystem>();
+	if (!TestNotNull(TEXT("Dissolve subsystem"), DissolveSubsystem)) return false;
+	const int32 MaxMIDs = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.Dissolve.MaxMIDs"))->GetInt();
+
+	// All of them start dissolving in the same frame, far more than the pool can serve at once
+	for (AAuraEnemy* Enemy : Enemies)
+	{
+		DissolveSubsystem->StartDissolve(Enemy);
+	}
+	TestTrue(TEXT("Some dissolves wait for the pool"), DissolveSubsystem->GetNumPendingDissolves() > 0);
+
+	int32 MaxLiveMIDs = DissolveSubsystem->GetNumLiveMIDs();
+	int32 MaxPoolMIDs = DissolveSubsystem->GetNumMIDs();
+	constexpr float DeltaSeconds = 0.1f;
+	for (int32 Frame = 0; Frame < 2000 && DissolveSubsystem->GetNumActiveDissolves() + DissolveSubsystem->GetNumPendingDissolves() > 0; ++Frame)
+	{
+		TestWorld.Tick(DeltaSeconds);
+		MaxLiveMIDs = FMath::Max(MaxLiveMIDs, DissolveSubsystem->GetNumLiveMIDs());
+		MaxPoolMIDs = FMath::Max(MaxPoolMIDs, DissolveSubsystem->GetNumMIDs());
+	}
+
+	TestTrue(FString::Printf(TEXT("Live MIDs peaked at %d, within Aura.Dissolve.MaxMIDs %d"), MaxLiveMIDs, MaxMIDs), MaxLiveMIDs <= MaxMIDs);
+	TestTrue(FString::Printf(TEXT("Pooled MIDs peaked at %d, within Aura.Dissolve.MaxMIDs %d"), MaxPoolMIDs, MaxMIDs), MaxPoolMIDs <= MaxMIDs);
+	TestTrue(TEXT("The pool was used"), MaxLiveMIDs > 0);
+	TestEqual(TEXT("Active dissolves once every dissolve finished"), DissolveSubsystem->GetNumActiveDissolves(), 0);
+	TestEqual(TEXT("Pending dissolves once every dissolve finished"), DissolveSubsystem->GetNumPendingDissolves(), 0);
+	TestEqual(TEXT("Live MIDs once every dissolve finished"), DissolveSubsystem->GetNumLiveMIDs(), 0);
+
+	int32 NumVisible = 0;
+	for (const AAuraEnemy* Enemy : Enemies)
+	{
+		NumVisible += Enemy->GetMesh()->IsVisible() ? 1 : 0;
+	}
+	TestEqual(TEXT("Enemies whose dissolve never finished"), NumVisible, 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright Adam Thomas
+
+
+#include "Tests/AuraTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Character/AuraEnemy.h"
+#include "Character/AuraSignificanceSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraSignificanceCorpseTickIntervalTest, "Aura.Significance.CorpseTickInterval", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FAuraSignificanceCorpseTickIntervalTest::RunTest(const FString& Parameters)
+{
+	const FAuraTestWorld TestWorld;
+	if (!TestWorld.IsValid())
+	{
+		AddError(FString::Printf(TEXT("%s has no character class info"), FAuraTestWorld::DefaultGameModePath));
+		return false;
+	}
+	UWorld* World = TestWorld.GetWorld();
+
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	PlayerController->Possess(World->SpawnActor<APawn>());
+
+	// Both far enough from the viewer to be Low
+	AAuraEnemy* LiveEnemy = TestWorld.SpawnEnemy(FVector(20000.f, 0.f, 0.f));
+	AAuraEnemy* DeadEnemy = TestWorld.SpawnEnemy(FVector(20000.f, 1000.f, 0.f));
+
+	UAuraSignificanceSubsystem* SignificanceSubsystem = World->GetSubsystem<UAuraSignificanceSubsystem>();
+	const float UpdateInterval = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.Significance.UpdateInterval"))->GetFloat();
+	SignificanceSubsystem->Tick(UpdateInterval);
+
+	const float LowTickInterval = UAuraSignificanceSubsystem::GetTickInterval(EAuraSignificance::Low);
+	TestEqual(TEXT("Low significance mesh tick interval"), LiveEnemy->GetMesh()->GetComponentTickInterval(), LowTickInterval);
+	TestEqual(TEXT("Low significance mesh tick interval before death"), DeadEnemy->GetMesh()->GetComponentTickInterval(), LowTickInterval);
+
+	// Dying while already Low does not change the bucket, the death itself has to restore the ragdoll's tick rate
+	DeadEnemy->Die(FVector::ZeroVector);
+	SignificanceSubsystem->Tick(UpdateInterval);
+	TestEqual(TEXT("Corpse mesh tick interval"), DeadEnemy->GetMesh()->GetComponentTickInterval(), 0.f);
+	TestEqual(TEXT("Corpse weapon tick interval"), DeadEnemy->GetWeapon()->GetComponentTickInterval(), 0.f);
+
+	// A corpse that scores into Low later keeps its meshes ticking every frame
+	DeadEnemy->SetSignificance(EAuraSignificance::Medium);
+	DeadEnemy->SetSignificance(EAuraSignificance::Low);
+	TestEqual(TEXT("Corpse mesh tick interval after a bucket change"), DeadEnemy->GetMesh()->GetComponentTickInterval(), 0.f);
+	TestEqual(TEXT("Live enemy mesh tick interval is still reduced"), LiveEnemy->GetMesh()->GetComponentTickInterval(), LowTickInterval);
+	return true;
+}
+
+#endif
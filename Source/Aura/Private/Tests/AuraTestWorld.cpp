@@ -0,0 +1,52 @@
+// Copyright Adam Thomas
+
+
+#include "Tests/AuraTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "Character/AuraEnemy.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+FAuraTestWorld::FAuraTestWorld(const TCHAR* GameModePath)
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone(TEXT("AuraTestWorld"));
+	World = GameInstance->GetWorld();
+
+	const FURL URL(*(FString(TEXT("?game=")) + GameModePath));
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	CharacterClassInfo = UAuraAbilitySystemLibrary::GetCharacterClassInfo(World);
+}
+
+FAuraTestWorld::~FAuraTestWorld()
+{
+	GameInstance->Shutdown();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	GameInstance->RemoveFromRoot();
+}
+
+AAuraEnemy* FAuraTestWorld::SpawnEnemy(const FVector& Location, TSubclassOf<AAuraEnemy> EnemyClass) const
+{
+	const FTransform Transform(Location);
+	AAuraEnemy* Enemy = World->SpawnActorDeferred<AAuraEnemy>(EnemyClass ? *EnemyClass : AAuraEnemy::StaticClass(), Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	Enemy->AutoPossessAI = EAutoPossessAI::Disabled;
+	Enemy->FinishSpawning(Transform);
+	return Enemy;
+}
+
+void FAuraTestWorld::Tick(float DeltaSeconds) const
+{
+	++GFrameCounter;
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+}
+
+#endif
@@ -0,0 +1,51 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class AAuraEnemy;
+class UCharacterClassInfo;
+class UGameInstance;
+class UWorld;
+
+/**
+ * A standalone game world running the game mode, so the class info, damage execution and default attributes behave as in game.
+ * For automation tests, shut down when it goes out of scope. Works headless with -nullrhi.
+ */
+class FAuraTestWorld
+{
+public:
+
+	static constexpr const TCHAR* DefaultGameModePath = TEXT("/Game/Blueprints/Game/BP_AuraGameModeBase.BP_AuraGameModeBase_C");
+
+	explicit FAuraTestWorld(const TCHAR* GameModePath = DefaultGameModePath);
+	~FAuraTestWorld();
+
+	FAuraTestWorld(const FAuraTestWorld&) = delete;
+	FAuraTestWorld& operator=(const FAuraTestWorld&) = delete;
+
+	/** False if the game mode has no character class info, which every Aura fixture needs */
+	bool IsValid() const { return CharacterClassInfo != nullptr; }
+
+	UWorld* GetWorld() const { return World; }
+	UGameInstance* GetGameInstance() const { return GameInstance; }
+	const UCharacterClassInfo* GetCharacterClassInfo() const { return CharacterClassInfo; }
+
+	/** Spawns an enemy with its default attributes, the native class unless EnemyClass is given. Never possessed, so no AI runs */
+	AAuraEnemy* SpawnEnemy(const FVector& Location, TSubclassOf<AAuraEnemy> EnemyClass = nullptr) const;
+
+	/** Advances the world a frame */
+	void Tick(float DeltaSeconds) const;
+
+private:
+
+	UGameInstance* GameInstance = nullptr;
+	UWorld* World = nullptr;
+	const UCharacterClassInfo* CharacterClassInfo = nullptr;
+};
+
+#endif
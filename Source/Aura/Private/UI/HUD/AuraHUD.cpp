@@ -6,6 +6,8 @@
 #include "UI/WidgetController/AttributeMenuWidgetController.h"
 #include "UI/WidgetController/OverlayWidgetController.h"
 #include "UI/WidgetController/SpellMenuWidgetController.h"
+#include "UI/HUD/AuraHealthBarSubsystem.h"
+#include "Engine/Canvas.h"
 
 UOverlayWidgetController* AAuraHUD::GetOverlayWidgetController(const FWidgetControllerParams& WCParams)
 {
@@ -59,3 +61,36 @@ void AAuraHUD::InitOverlay(APlayerController* PC, APlayerState* PS, UAbilitySyst
 	Widget->AddToViewport();
 }
 
+void AAuraHUD::DrawHUD()
+{
+	Super::DrawHUD();
+	DrawHealthBars();
+}
+
+void AAuraHUD::DrawHealthBars()
+{
+	const UAuraHealthBarSubsystem* HealthBarSubsystem = GetWorld()->GetSubsystem<UAuraHealthBarSubsystem>();
+	if (HealthBarSubsystem == nullptr || Canvas == nullptr) return;
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const FVector2D HalfSize = HealthBarSize * 0.5f;
+
+	for (const FAuraHealthBarEntry& Entry : HealthBarSubsystem->GetEntries())
+	{
+		if (Entry.LastDamageTime < 0.f || Now - Entry.LastDamageTime > HealthBarDisplayTime || Entry.MaxHealth <= 0.f) continue;
+
+		const AActor* Actor = Entry.Actor.Get();
+		if (Actor == nullptr || Actor->IsHidden() || !Actor->WasRecentlyRendered(0.1f)) continue;
+
+		const FVector ScreenLocation = Project(Actor->GetActorLocation() + FVector(0.f, 0.f, Entry.HeightOffset), true);
+		if (ScreenLocation.Z <= 0.f) continue;
+		if (ScreenLocation.X < -HalfSize.X || ScreenLocation.X > Canvas->ClipX + HalfSize.X || ScreenLocation.Y < -HalfSize.Y || ScreenLocation.Y > Canvas->ClipY + HalfSize.Y) continue;
+
+		const float Percent = FMath::Clamp(Entry.Health / Entry.MaxHealth, 0.f, 1.f);
+		const float Left = ScreenLocation.X - HalfSize.X;
+		const float Top = ScreenLocation.Y - HalfSize.Y;
+
+		DrawRect(HealthBarBackgroundColour, Left, Top, HealthBarSize.X, HealthBarSize.Y);
+		DrawRect(HealthBarColour, Left, Top, HealthBarSize.X * Percent, HealthBarSize.Y);
+	}
+}
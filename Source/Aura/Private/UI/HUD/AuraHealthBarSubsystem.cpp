@@ -0,0 +1,55 @@
+// Copyright Adam Thomas
+
+
+#include "UI/HUD/AuraHealthBarSubsystem.h"
+#include "Aura/Aura.h"
+
+bool UAuraHealthBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WITH_AURA_COSMETICS && (WorldType == EWorldType::Game || WorldType == EWorldType::PIE);
+}
+
+void UAuraHealthBarSubsystem::Register(AActor* Actor, float HeightOffset, float Health, float MaxHealth)
+{
+	if (!IsValid(Actor) || EntryIndices.Contains(Actor)) return;
+
+	EntryIndices.Add(Actor, Entries.Num());
+	FAuraHealthBarEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Actor = Actor;
+	Entry.HeightOffset = HeightOffset;
+	Entry.Health = Health;
+	Entry.MaxHealth = MaxHealth;
+}
+
+void UAuraHealthBarSubsystem::Unregister(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+	if (!EntryIndices.RemoveAndCopyValue(Actor, Index)) return;
+
+	Entries.RemoveAtSwap(Index, 1, false);
+	if (Entries.IsValidIndex(Index))
+	{
+		EntryIndices.Add(Entries[Index].Actor, Index);
+	}
+}
+
+void UAuraHealthBarSubsystem::SetHealth(AActor* Actor, float Health)
+{
+	if (const int32* Index = EntryIndices.Find(Actor))
+	{
+		FAuraHealthBarEntry& Entry = Entries[*Index];
+		if (Health < Entry.Health)
+		{
+			Entry.LastDamageTime = GetWorld()->GetTimeSeconds();
+		}
+		Entry.Health = Health;
+	}
+}
+
+void UAuraHealthBarSubsystem::SetMaxHealth(AActor* Actor, float MaxHealth)
+{
+	if (const int32* Index = EntryIndices.Find(Actor))
+	{
+		Entries[*Index].MaxHealth = MaxHealth;
+	}
+}
@@ -8,9 +8,13 @@
 #include "Player/AuraPlayerState.h"
 #include "AbilitySystem/Data/LevelUpInfo.h"
 #include "AuraGameplayTags.h"
+#include "Aura/AuraStats.h"
 
 void UOverlayWidgetController::BroadcastInitialValues()
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraWidgetBroadcast);
+	INC_DWORD_STAT_BY(STAT_AuraWidgetBroadcasts, 4);
+
 	OnHealthChanged.Broadcast(GetAuraAS()->GetHealth());
 	OnMaxHealthChanged.Broadcast(GetAuraAS()->GetMaxHealth());
 
@@ -32,6 +36,8 @@ void UOverlayWidgetController::BindCallbacksToDependencies()
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(GetAuraAS()->
 		GetHealthAttribute()).AddLambda([this](const FOnAttributeChangeData& Data)
 			{
+				SCOPE_CYCLE_COUNTER(STAT_AuraWidgetBroadcast);
+				INC_DWORD_STAT(STAT_AuraWidgetBroadcasts);
 				OnHealthChanged.Broadcast(Data.NewValue);
 			}
 		);
@@ -39,6 +45,8 @@ void UOverlayWidgetController::BindCallbacksToDependencies()
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(GetAuraAS()->
 		GetMaxHealthAttribute()).AddLambda([this](const FOnAttributeChangeData& Data)
 			{
+				SCOPE_CYCLE_COUNTER(STAT_AuraWidgetBroadcast);
+				INC_DWORD_STAT(STAT_AuraWidgetBroadcasts);
 				OnMaxHealthChanged.Broadcast(Data.NewValue);
 			}
 		);
@@ -46,6 +54,8 @@ void UOverlayWidgetController::BindCallbacksToDependencies()
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(GetAuraAS()->
 		GetManaAttribute()).AddLambda([this](const FOnAttributeChangeData& Data)
 			{
+				SCOPE_CYCLE_COUNTER(STAT_AuraWidgetBroadcast);
+				INC_DWORD_STAT(STAT_AuraWidgetBroadcasts);
 				OnManaChanged.Broadcast(Data.NewValue);
 			}
 		);
@@ -53,6 +63,8 @@ void UOverlayWidgetController::BindCallbacksToDependencies()
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(GetAuraAS()->
 		GetMaxManaAttribute()).AddLambda([this](const FOnAttributeChangeData& Data)
 			{
+				SCOPE_CYCLE_COUNTER(STAT_AuraWidgetBroadcast);
+				INC_DWORD_STAT(STAT_AuraWidgetBroadcasts);
 				OnMaxManaChanged.Broadcast(Data.NewValue);
 			}
 		);
@@ -96,6 +108,9 @@ void UOverlayWidgetController::BindCallbacksToDependencies()
 
 void UOverlayWidgetController::OnXPChanged(int32 NewXP)
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraWidgetBroadcast);
+	INC_DWORD_STAT(STAT_AuraWidgetBroadcasts);
+
 	const ULevelUpInfo* LevelUpInfo = GetAuraPS()->LevelUpInfo;
 	checkf(LevelUpInfo, TEXT("Unable to find LevelUpInfo. Please fill in the AuraPlayerState Blueprint."));
 
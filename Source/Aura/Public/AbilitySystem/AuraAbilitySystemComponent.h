@@ -68,13 +68,42 @@ public:
 
 	static bool AbilityHasSlot(FGameplayAbilitySpec* Spec, const FGameplayTag& Slot);
 
+	/** Activates the Effects_HitReact ability through a cached handle, hits in the same frame or within the cooldown are merged into one react */
+	bool TryActivateHitReact();
+
+	/** Seed for the rolls of the next damage effect this component causes, unique per effect and reproducible from RollSeedBase */
+	uint64 NextRollSeed();
+
+	/** Pins the roll sequence, for replaying a session or deterministic tests */
+	void SetRollSeedBase(uint64 InRollSeedBase);
+
+	uint64 GetRollSeedBase() const { return RollSeedBase; }
+	uint32 GetRollCounter() const { return RollCounter; }
+
 protected:
 
 	virtual void OnRep_ActivateAbilities() override;
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
 
 	UFUNCTION(Client, Reliable)
 	void ClientEffectApplied(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec, FActiveGameplayEffectHandle ActiveEffectHandle);
 
+	void TraceEffectApplied(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec, FActiveGameplayEffectHandle ActiveEffectHandle);
+
 	UFUNCTION(Client, Reliable)
 	void ClientUpdateAbilityStatus(const FGameplayTag& AbilityTag, const FGameplayTag& StatusTag, int32 AbilityLevel);
+
+private:
+
+	FGameplayAbilitySpecHandle CachedHitReactHandle;
+	bool bHitReactHandleDirty = true;
+	uint64 LastHitReactFrame = 0;
+	double LastHitReactTime = -DBL_MAX;
+
+	// Server only, damage rolls are not predicted so clients never need it
+	uint64 RollSeedBase = 0;
+
+	uint32 RollCounter = 0;
 };
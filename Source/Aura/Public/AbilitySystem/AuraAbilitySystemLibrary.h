@@ -107,6 +107,9 @@ public:
 
 	static int32 GetXPRewardForClassAndLevel(const UObject* WorldContextObject, ECharacterClass CharacterClass, int32 CharacterLevel);
 
+	static uint64 GetRollSeed(const FGameplayEffectContextHandle& EffectContextHandle);
+	static void SetRollSeed(FGameplayEffectContextHandle& EffectContextHandle, uint64 InRollSeed);
+
 private:
 
 	static void ApplyAttributes(UAbilitySystemComponent* ASC, AActor* AvatarActor, TSubclassOf<UGameplayEffect> EffectClass, float Level);
@@ -53,6 +53,31 @@ struct FEffectProperties
 	ACharacter* TargetCharacter = nullptr;
 };
 
+/** Vital value expressed as a function of time, so regeneration needs no periodic updates */
+USTRUCT()
+struct FAuraVitalRegen
+{
+	GENERATED_BODY()
+
+	// Value of the vital at AnchorTime
+	UPROPERTY()
+	float AnchorValue = 0.f;
+
+	// Per second
+	UPROPERTY()
+	float Rate = 0.f;
+
+	// Server world time
+	UPROPERTY()
+	double AnchorTime = 0.0;
+
+	float Evaluate(double Now, float MaxValue) const
+	{
+		if (Rate <= 0.f || AnchorValue >= MaxValue) return AnchorValue;
+		return FMath::Min(AnchorValue + Rate * static_cast<float>(FMath::Max(Now - AnchorTime, 0.0)), MaxValue);
+	}
+};
+
 // typedef is specific to FGameplayAttribute() signature, but TStaticFuncPtr is generic to any signature chosen
 //typedef TBaseStaticDelegateInstance<FGameplayAttribute(), FDefaultDelegateUserPolicy>::FFuncPtr FAttributeFuncPtr;
 template<class T>
@@ -71,11 +96,28 @@ public:
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	virtual void PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue) override;
+	virtual bool PreGameplayEffectExecute(FGameplayEffectModCallbackData& Data) override;
 	virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
 	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
 
 	TMap<FGameplayTag, TStaticFuncPtr<FGameplayAttribute()>> TagsToAttributes;
 
+	/** Applies damage ticked by UAuraDoTSubsystem, skipping hit react and debuff rolls */
+	void HandlePeriodicDamage(UAbilitySystemComponent* SourceASC, float Damage);
+
+	/** Adds XP to Recipient and processes every level up it earns in one pass */
+	void GrantXP(AActor* Recipient, int32 XP);
+
+	/** Server: writes regenerated Health/Mana into the attributes, call before modifying either. Re-anchors only when a rate changed */
+	void SettleRegen();
+
+	/** Health/Mana including regeneration since the last settle, without writing them */
+	float GetSettledHealth() const;
+	float GetSettledMana() const;
+
+	/** Clients: moves the local Health/Mana values along the replicated regen curves for display */
+	void ExtrapolateRegen();
+
 
 	/*
 	* Primary Attributes
@@ -153,6 +195,16 @@ public:
 	FGameplayAttributeData Mana;
 	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Mana);
 
+	/*
+	* Analytic Regeneration, only replicated when the rate changes or the vital is corrected
+	*/
+
+	UPROPERTY(ReplicatedUsing = OnRep_HealthRegenState)
+	FAuraVitalRegen HealthRegenState;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ManaRegenState)
+	FAuraVitalRegen ManaRegenState;
+
 	/**
 	* Resistance Attributes
 	*/
@@ -195,6 +247,12 @@ public:
 	UFUNCTION()
 	void OnRep_Mana(const FGameplayAttributeData& OldMana) const;
 
+	UFUNCTION()
+	void OnRep_HealthRegenState();
+
+	UFUNCTION()
+	void OnRep_ManaRegenState();
+
 	/*
 	* Primary Attribute Rep Notify Functions
 	*/
@@ -267,8 +325,17 @@ private:
 	void HandleIncomingXP(const FEffectProperties& Props);
 	void Debuff(const FEffectProperties& Props);
 	void GetEffectProperties(const FGameplayEffectModCallbackData& Data, FEffectProperties& Props) const;
+	void SetSourceProperties(UAbilitySystemComponent* SourceASC, FEffectProperties& Props) const;
+	void SetTargetProperties(UAbilitySystemComponent* TargetASC, FEffectProperties& Props) const;
 	void ShowFloatingText(const FEffectProperties& Props, float Damage, bool bBlockedHit, bool bCriticalHit) const;
 	void SendXPEvent(const FEffectProperties& Props);
+	bool IsRegenEffectExecution(const FGameplayEffectModCallbackData& Data) const;
+	void SettleVitalRegen(const FGameplayAttribute& VitalAttribute);
+	void SettleVital(FAuraVitalRegen& RegenState, const FGameplayAttribute& VitalAttribute, float MaxValue, float NewRate, double Now);
+	static float EvaluateVital(const FAuraVitalRegen& RegenState, float CurrentValue, float MaxValue, double Now);
+	double GetRegenTime() const;
+	float GetRegenRate(float RegenAttributeValue) const;
 	bool bTopOffHealth = false;
 	bool bTopOffMana = false;
+	bool bSettlingRegen = false;
 };
@@ -0,0 +1,81 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Small seedable xoshiro128** generator for gameplay rolls.
+ * The same seed always produces the same sequence on every platform, so the roll seed carried in an
+ * effect context and written to the combat log lets replays and tests reproduce the server's outcomes exactly.
+ */
+struct FAuraRandomStream
+{
+	explicit FAuraRandomStream(uint64 Seed)
+	{
+		Initialise(Seed);
+	}
+
+	void Initialise(uint64 Seed)
+	{
+		// SplitMix64 spreads any seed, including zero, over the full state
+		const uint64 A = SplitMix64(Seed);
+		const uint64 B = SplitMix64(Seed);
+		State[0] = static_cast<uint32>(A);
+		State[1] = static_cast<uint32>(A >> 32);
+		State[2] = static_cast<uint32>(B);
+		State[3] = static_cast<uint32>(B >> 32);
+	}
+
+	uint32 Next()
+	{
+		const uint32 Result = RotateLeft(State[1] * 5, 7) * 9;
+		const uint32 T = State[1] << 9;
+
+		State[2] ^= State[0];
+		State[3] ^= State[1];
+		State[1] ^= State[2];
+		State[0] ^= State[3];
+		State[2] ^= T;
+		State[3] = RotateLeft(State[3], 11);
+
+		return Result;
+	}
+
+	/** Uniform in [0, 1) */
+	float GetFraction()
+	{
+		return static_cast<float>(Next() >> 8) * (1.f / 16777216.f);
+	}
+
+	/** Uniform in [Min, Max], inclusive like FMath::RandRange */
+	int32 RandRange(int32 Min, int32 Max)
+	{
+		const uint64 Range = static_cast<uint64>(static_cast<int64>(Max) - Min + 1);
+		return Min + static_cast<int32>((static_cast<uint64>(Next()) * Range) >> 32);
+	}
+
+	/** Derives the seed of the Index'th roll sequence from a base seed */
+	static uint64 MixSeed(uint64 BaseSeed, uint64 Index)
+	{
+		uint64 State = BaseSeed ^ (Index * 0xD1B54A32D192ED03ull);
+		return SplitMix64(State);
+	}
+
+private:
+
+	static uint64 SplitMix64(uint64& InOutState)
+	{
+		uint64 Z = (InOutState += 0x9E3779B97F4A7C15ull);
+		Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+		return Z ^ (Z >> 31);
+	}
+
+	static uint32 RotateLeft(uint32 Value, int32 Shift)
+	{
+		return (Value << Shift) | (Value >> (32 - Shift));
+	}
+
+	uint32 State[4];
+};
@@ -0,0 +1,108 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UCurveTable;
+struct FRealCurve;
+class IMappedFileHandle;
+class IMappedFileRegion;
+struct FScalableFloat;
+
+/**
+ * A curve table pre-sampled at every whole level from 0 to MaxLevel and stored as one flat float array.
+ * Written by UAuraCompileCurvesCommandlet and memory mapped at runtime, along with a hash of the curve table asset it was checked against.
+ * Lookups index the array directly. Rows that use constant interpolation in the asset hold the lower level's value,
+ * all others lerp between neighbouring levels, which is exact for linear rows but only matches cubic rows at whole levels.
+ */
+class AURA_API FAuraCompiledCurveTable
+{
+public:
+
+	static constexpr uint32 Magic = 0x54435541; // 'AUCT'
+	static constexpr uint32 Version = 2;
+
+	FAuraCompiledCurveTable();
+	~FAuraCompiledCurveTable();
+
+	/** Validates Table, checks its rows match SourceAsset at every whole level and samples them. MaxLevel <= 0 uses the highest key time */
+	static bool Compile(const UCurveTable& Table, const UCurveTable& SourceAsset, int32 MaxLevel, TArray<uint8>& OutBytes, TArray<FString>& OutErrors);
+
+	/** Hash of the row names, keys, interpolation and tangents, changes whenever the asset is edited */
+	static uint32 HashSource(const UCurveTable& Table);
+
+	bool Load(const FString& Filename);
+
+	uint32 GetSourceHash() const { return SourceHash; }
+
+	int32 FindRow(FName RowName) const;
+	float Eval(int32 RowIndex, float Level) const;
+	bool Eval(FName RowName, float Level, float& OutValue) const;
+
+	int32 GetNumRows() const { return NumRows; }
+	int32 GetNumLevels() const { return NumLevels; }
+
+private:
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NumRows;
+		uint32 NumLevels;
+		uint32 NamesOffset;
+		uint32 NamesSize;
+		uint32 SamplesOffset;
+		uint32 SourceHash;
+	};
+
+	enum ERowFlags : uint8
+	{
+		RowFlag_Constant = 1 << 0
+	};
+
+	static bool IsConstantCurve(const FRealCurve& Curve);
+	bool Parse(const uint8* Data, int64 Size);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Used instead of the mapping on platforms that cannot map files
+	TArray<uint8> LoadedBytes;
+
+	const float* Samples = nullptr;
+	int32 NumRows = 0;
+	int32 NumLevels = 0;
+	uint32 SourceHash = 0;
+	TMap<FName, int32> RowIndices;
+	TBitArray<> ConstantRows;
+};
+
+/**
+ * Singleton holding the compiled curve tables, loaded on first use from Content/CompiledCurves by the table's package path.
+ * Falls back to the curve table assets when a table or row has not been compiled. Editor builds also hash each asset once and
+ * fall back with a warning when it was edited after its table was compiled, cooked builds trust the files, which
+ * -run=AuraCompileCurves -ValidateOnly checks before cooking. Game thread only.
+ */
+class AURA_API FAuraCompiledCurves
+{
+public:
+
+	static FAuraCompiledCurves& Get();
+	static bool IsEnabled();
+	static FString GetCompiledDirectory();
+	/** Content/CompiledCurves/<package path>.auracurve, so tables of the same name in different packages never share a file */
+	static FString GetCompiledFilename(const FString& PackageName);
+
+	const FAuraCompiledCurveTable* FindTable(const UCurveTable& Table);
+
+	float EvalCurve(const UCurveTable* Table, FName RowName, float Level);
+	float EvalScalableFloat(const FScalableFloat& ScalableFloat, float Level);
+
+private:
+
+	// Null entries record tables with no compiled file so they are only looked for once
+	TMap<FObjectKey, TUniquePtr<FAuraCompiledCurveTable>> Tables;
+};
@@ -0,0 +1,60 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "AuraDoTSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UAuraAttributeSet;
+
+/**
+ * Server side ticker for damage over time debuffs.
+ * Active DoTs are stored as a struct of arrays and advanced in a single pass per frame.
+ * Damage from each source's DoTs on a target is summed and applied once per frame, without hit react or a new debuff roll.
+ */
+UCLASS()
+class AURA_API UAuraDoTSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Starts a DoT and deals its first tick straight away, or refreshes it if the source already has one of this type on the target
+	 * (AggregateBySource, stack limit 1). Frequency is the seconds between ticks, values <= 0 are rejected and anything under 0.05 is clamped */
+	void AddDoT(UAbilitySystemComponent* SourceASC, UAbilitySystemComponent* TargetASC, const FGameplayTag& DebuffTag, float InDamagePerTick, float Frequency, float Duration);
+
+	void RemoveDoTsOnTarget(const UAbilitySystemComponent* TargetASC);
+
+	int32 GetNumActiveDoTs() const { return TargetASCs.Num(); }
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void RemoveDoTAt(int32 Index);
+	void ApplyDamage(UAbilitySystemComponent* SourceASC, UAbilitySystemComponent* TargetASC, float Damage);
+	static UAuraAttributeSet* GetAuraAttributeSet(const UAbilitySystemComponent* ASC);
+
+	// Target, then source
+	using FDoTKey = TPair<TWeakObjectPtr<UAbilitySystemComponent>, TWeakObjectPtr<UAbilitySystemComponent>>;
+
+	// Active DoTs, one entry per (Source, Target, DebuffTag), all arrays share the same index
+	TArray<TWeakObjectPtr<UAbilitySystemComponent>> SourceASCs;
+	TArray<TWeakObjectPtr<UAbilitySystemComponent>> TargetASCs;
+	TArray<FGameplayTag> DebuffTags;
+	TArray<float> DamagePerTick;
+	TArray<float> Periods;
+	TArray<float> TimeUntilNextTick;
+	TArray<float> TimeRemaining;
+
+	// Reused every frame to sum the damage per target and source
+	TMap<FDoTKey, float> PendingDamage;
+};
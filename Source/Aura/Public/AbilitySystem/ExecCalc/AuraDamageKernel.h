@@ -0,0 +1,107 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The damage formula used by UExecCalc_Damage, free of GameplayEffect types so it can also run offline.
+ * Rolls are in [1, 100] and succeed when lower than the chance, as in the ExecCalc.
+ */
+struct FAuraDamageKernel
+{
+	static FORCEINLINE float ApplyResistance(float Damage, float Resistance)
+	{
+		return Damage * (100.f - FMath::Clamp(Resistance, 0.f, 100.f)) / 100.f;
+	}
+
+	static FORCEINLINE float ApplyBlock(float Damage, bool bBlocked)
+	{
+		return bBlocked ? Damage / 2.f : Damage;
+	}
+
+	/** Armour Penetration ignores a percentage of the target's Armour, the remaining Armour ignores a percentage of the damage */
+	static FORCEINLINE float ApplyArmour(float Damage, float TargetArmour, float SourceArmourPenetration, float ArmourPenetrationCoefficient, float EffectiveArmourCoefficient)
+	{
+		const float EffectiveArmour = TargetArmour * (100.f - SourceArmourPenetration * ArmourPenetrationCoefficient) / 100.f;
+		return Damage * (100.f - EffectiveArmour * EffectiveArmourCoefficient) / 100.f;
+	}
+
+	static FORCEINLINE float GetEffectiveCriticalHitChance(float SourceCriticalHitChance, float TargetCriticalHitResistance, float CriticalHitResistanceCoefficient)
+	{
+		return SourceCriticalHitChance - TargetCriticalHitResistance * CriticalHitResistanceCoefficient;
+	}
+
+	static FORCEINLINE float ApplyCriticalHit(float Damage, bool bCriticalHit, float SourceCriticalHitDamage)
+	{
+		return bCriticalHit ? 2.f * Damage + SourceCriticalHitDamage : Damage;
+	}
+
+	/** Matches UMMC_MaxHealth */
+	static FORCEINLINE float GetMaxHealth(float Vigor, int32 Level)
+	{
+		return 80.f + 2.5f * Vigor + 10.f * Level;
+	}
+
+	/**
+	 * Hits stored as a struct of arrays for ComputeBatch. Damage is after resistances, rolls are in [1, 100].
+	 * The level based coefficients are shared by the whole batch.
+	 */
+	struct FBatch
+	{
+		int32 Num = 0;
+		const float* Damage = nullptr;
+		const float* BlockRoll = nullptr;
+		const float* CriticalHitRoll = nullptr;
+		const float* TargetBlockChance = nullptr;
+		const float* TargetArmour = nullptr;
+		const float* SourceArmourPenetration = nullptr;
+		const float* SourceCriticalHitChance = nullptr;
+		const float* TargetCriticalHitResistance = nullptr;
+		const float* SourceCriticalHitDamage = nullptr;
+
+		float ArmourPenetrationCoefficient = 0.f;
+		float EffectiveArmourCoefficient = 0.f;
+		float CriticalHitResistanceCoefficient = 0.f;
+	};
+
+	/** Evaluates block, armour and crit for every hit in Batch, four hits per vector register */
+	static void ComputeBatch(const FBatch& Batch, float* OutDamage)
+	{
+		const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+		const VectorRegister4Float Two = VectorSetFloat1(2.f);
+		const VectorRegister4Float Hundred = VectorSetFloat1(100.f);
+		const VectorRegister4Float InvHundred = VectorSetFloat1(0.01f);
+		const VectorRegister4Float ArmourPenetrationCoefficient = VectorSetFloat1(Batch.ArmourPenetrationCoefficient);
+		const VectorRegister4Float EffectiveArmourCoefficient = VectorSetFloat1(Batch.EffectiveArmourCoefficient);
+		const VectorRegister4Float CriticalHitResistanceCoefficient = VectorSetFloat1(Batch.CriticalHitResistanceCoefficient);
+
+		const int32 NumVectorised = Batch.Num & ~3;
+		for (int32 Index = 0; Index < NumVectorised; Index += 4)
+		{
+			VectorRegister4Float Damage = VectorLoad(Batch.Damage + Index);
+
+			const VectorRegister4Float Blocked = VectorCompareLT(VectorLoad(Batch.BlockRoll + Index), VectorLoad(Batch.TargetBlockChance + Index));
+			Damage = VectorSelect(Blocked, VectorMultiply(Damage, Half), Damage);
+
+			const VectorRegister4Float ArmourIgnored = VectorMultiply(VectorLoad(Batch.SourceArmourPenetration + Index), ArmourPenetrationCoefficient);
+			const VectorRegister4Float EffectiveArmour = VectorMultiply(VectorMultiply(VectorLoad(Batch.TargetArmour + Index), VectorSubtract(Hundred, ArmourIgnored)), InvHundred);
+			Damage = VectorMultiply(Damage, VectorMultiply(VectorSubtract(Hundred, VectorMultiply(EffectiveArmour, EffectiveArmourCoefficient)), InvHundred));
+
+			const VectorRegister4Float CriticalHitChance = VectorSubtract(VectorLoad(Batch.SourceCriticalHitChance + Index),
+				VectorMultiply(VectorLoad(Batch.TargetCriticalHitResistance + Index), CriticalHitResistanceCoefficient));
+			const VectorRegister4Float CriticalHit = VectorCompareLT(VectorLoad(Batch.CriticalHitRoll + Index), CriticalHitChance);
+			Damage = VectorSelect(CriticalHit, VectorMultiplyAdd(Damage, Two, VectorLoad(Batch.SourceCriticalHitDamage + Index)), Damage);
+
+			VectorStore(Damage, OutDamage + Index);
+		}
+
+		for (int32 Index = NumVectorised; Index < Batch.Num; ++Index)
+		{
+			float Damage = ApplyBlock(Batch.Damage[Index], Batch.BlockRoll[Index] < Batch.TargetBlockChance[Index]);
+			Damage = ApplyArmour(Damage, Batch.TargetArmour[Index], Batch.SourceArmourPenetration[Index], Batch.ArmourPenetrationCoefficient, Batch.EffectiveArmourCoefficient);
+			const float CriticalHitChance = GetEffectiveCriticalHitChance(Batch.SourceCriticalHitChance[Index], Batch.TargetCriticalHitResistance[Index], Batch.CriticalHitResistanceCoefficient);
+			OutDamage[Index] = ApplyCriticalHit(Damage, Batch.CriticalHitRoll[Index] < CriticalHitChance, Batch.SourceCriticalHitDamage[Index]);
+		}
+	}
+};
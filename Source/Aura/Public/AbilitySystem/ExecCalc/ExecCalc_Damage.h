@@ -6,6 +6,8 @@
 #include "GameplayEffectExecutionCalculation.h"
 #include "ExecCalc_Damage.generated.h"
 
+struct FAuraRandomStream;
+
 /**
  * 
  */
@@ -22,5 +24,6 @@ public:
 	void DetermineDebuff(const FGameplayEffectCustomExecutionParameters& ExecutionParams, 
 						const FGameplayEffectSpec& Spec, 
 						FAggregatorEvaluateParameters EvaluationParams,
-						const TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition>& InTagsToDefs) const;
+						const TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition>& InTagsToDefs,
+						FAuraRandomStream& RollStream) const;
 };
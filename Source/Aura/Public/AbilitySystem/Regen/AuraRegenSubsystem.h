@@ -0,0 +1,37 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraRegenSubsystem.generated.h"
+
+class UAuraAttributeSet;
+
+/**
+ * Drives the displayed Health/Mana of regenerating attribute sets.
+ * Clients extrapolate locally from the replicated regen anchors, listen servers and standalone only settle the local player's vitals.
+ * Does nothing on dedicated servers, where vitals are only settled when they are read or modified.
+ */
+UCLASS()
+class AURA_API UAuraRegenSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register(UAuraAttributeSet* AttributeSet);
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	TSet<TWeakObjectPtr<UAuraAttributeSet>> AttributeSets;
+
+	float TimeSinceClientUpdate = 0.f;
+};
@@ -0,0 +1,49 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AttributeSet.h"
+#include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "AuraAttributeSnapshotSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+
+/**
+ * Caches the default attribute values of each character class and level.
+ * The first enemy of a class and level is initialised through the default attribute effects and captured,
+ * later ones have the captured values written straight into their base values. Attributes derived by the infinite secondary
+ * attribute effect are not written, that effect is still applied so they keep following the primaries.
+ */
+UCLASS()
+class AURA_API UAuraAttributeSnapshotSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Writes the cached values into ASC's base values and applies SecondaryAttributes,
+	 * false if there is no snapshot yet or snapshots are disabled */
+	bool ApplySnapshot(UAbilitySystemComponent* ASC, ECharacterClass CharacterClass, float Level, TSubclassOf<UGameplayEffect> SecondaryAttributes) const;
+
+	/** Records ASC's current values, call after the default attribute effects were applied to an otherwise unaffected ASC */
+	void CaptureSnapshot(const UAbilitySystemComponent* ASC, ECharacterClass CharacterClass, float Level, TSubclassOf<UGameplayEffect> SecondaryAttributes);
+
+	static bool IsEnabled();
+
+	int32 GetNumSnapshots() const { return Snapshots.Num(); }
+
+private:
+
+	void BuildAttributeOrder(const UAbilitySystemComponent* ASC, TSubclassOf<UGameplayEffect> SecondaryAttributes);
+
+	// Written attributes first, then the ones the secondary effect derives, then the vitals so they clamp against the final maximums
+	TArray<FGameplayAttribute> Attributes;
+	int32 NumWrittenAttributes = 0;
+	int32 NumDerivedAttributes = 0;
+
+	// Values are stored in the same order as Attributes
+	TMap<TTuple<ECharacterClass, int32>, TArray<float>> Snapshots;
+};
@@ -0,0 +1,38 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraXPLedgerSubsystem.generated.h"
+
+/**
+ * Server side ledger for kill XP.
+ * Rewards are accumulated per recipient during the frame and granted once per recipient when the ledger is flushed,
+ * so a multi kill costs a single level up check instead of one gameplay event and effect per kill.
+ */
+UCLASS()
+class AURA_API UAuraXPLedgerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Records the reward for Victim, shared between live players around it when Aura.XP.ShareRadius is above zero */
+	void AddKillXP(AActor* Killer, const AActor* Victim, int32 XPReward);
+
+	void Flush();
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void AddXP(AActor* Recipient, int32 XP);
+
+	TMap<TWeakObjectPtr<AActor>, int32> PendingXP;
+};
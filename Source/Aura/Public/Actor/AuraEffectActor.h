@@ -25,6 +25,10 @@ enum class EEffectRemovalPolicy
 	DoNotRemove
 };
 
+/**
+ * Applies gameplay effects to actors that overlap it, on the server only.
+ * Net dormant for its whole life, destroying it closes the channel on its own, see Aura.EffectActor.Dormancy.
+ */
 UCLASS()
 class AURA_API AAuraEffectActor : public AActor
 {
@@ -72,9 +76,22 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	EEffectRemovalPolicy InfiniteEffectRemovalPolicy = EEffectRemovalPolicy::RemoveOnEndOverlap;
 
-	TMap<FActiveGameplayEffectHandle, UAbilitySystemComponent*> ActiveEffectHandles;
+	/** Seconds between applications of the instant effect to everyone inside, instead of once per overlap. 0 applies it on overlap */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
+	float PeriodicApplicationInterval = 0.f;
+
+	// Infinite effects to remove per target when it leaves
+	TMap<TWeakObjectPtr<UAbilitySystemComponent>, TArray<FActiveGameplayEffectHandle, TInlineAllocator<2>>> ActiveEffectHandles;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	float ActorLevel = 1.f;
 
+private:
+
+	void AddPeriodicTarget(AActor* TargetActor);
+	void RemovePeriodicTarget(AActor* TargetActor);
+	void ApplyPeriodicEffect();
+
+	TArray<TWeakObjectPtr<UAbilitySystemComponent>> PeriodicTargets;
+	FTimerHandle PeriodicApplicationTimer;
 };
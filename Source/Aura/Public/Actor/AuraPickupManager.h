@@ -0,0 +1,263 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GameplayEffectTypes.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Actor/AuraEffectActor.h"
+#include "AuraPickupManager.generated.h"
+
+class AAuraPickupManager;
+class UGameplayEffect;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/** A kind of pickup, its mesh, overlap radius and the same effect settings as AAuraEffectActor */
+USTRUCT(BlueprintType)
+struct FAuraPickupType
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Pickup")
+	TObjectPtr<UStaticMesh> Mesh;
+
+	UPROPERTY(EditAnywhere, Category = "Pickup")
+	float Radius = 100.f;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	bool bDestroyOnEffectApplication = false;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	bool bApplyEffectsToEnemies = false;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	TSubclassOf<UGameplayEffect> InstantGameplayEffectClass;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	EEffectApplicationPolicy InstantEffectApplicationPolicy = EEffectApplicationPolicy::DoNotApply;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	TSubclassOf<UGameplayEffect> DurationGameplayEffectClass;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	EEffectApplicationPolicy DurationEffectApplicationPolicy = EEffectApplicationPolicy::DoNotApply;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	TSubclassOf<UGameplayEffect> InfiniteGameplayEffectClass;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	EEffectApplicationPolicy InfiniteEffectApplicationPolicy = EEffectApplicationPolicy::DoNotApply;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	EEffectRemovalPolicy InfiniteEffectRemovalPolicy = EEffectRemovalPolicy::RemoveOnEndOverlap;
+
+	UPROPERTY(EditAnywhere, Category = "Applied Effects")
+	float ActorLevel = 1.f;
+};
+
+/** One pickup, its world location and index into PickupTypes */
+USTRUCT(BlueprintType)
+struct FAuraPickupRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Pickup")
+	FVector3f Location = FVector3f::ZeroVector;
+
+	UPROPERTY(EditAnywhere, Category = "Pickup")
+	uint8 Type = 0;
+};
+
+/** Pickups added at runtime, Count of them on a grid of Columns from Corner, numbered on from FirstPickup */
+USTRUCT()
+struct FAuraPickupBatch : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	void PostReplicatedAdd(const struct FAuraPickupBatchArray& InArraySerializer);
+
+	UPROPERTY()
+	FVector3f Corner = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	float Spacing = 0.f;
+
+	UPROPERTY()
+	int32 FirstPickup = 0;
+
+	UPROPERTY()
+	int32 Count = 0;
+
+	UPROPERTY()
+	int32 Columns = 1;
+
+	UPROPERTY()
+	uint8 Type = 0;
+};
+
+USTRUCT()
+struct FAuraPickupBatchArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FAuraPickupBatch> Items;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AAuraPickupManager> Owner;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FAuraPickupBatch, FAuraPickupBatchArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FAuraPickupBatchArray> : public TStructOpsTypeTraitsBase2<FAuraPickupBatchArray>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/** A consumed pickup, by index */
+USTRUCT()
+struct FAuraConsumedPickup : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	void PostReplicatedAdd(const struct FAuraConsumedPickupArray& InArraySerializer);
+
+	UPROPERTY()
+	int32 Pickup = INDEX_NONE;
+};
+
+USTRUCT()
+struct FAuraConsumedPickupArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FAuraConsumedPickup> Items;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AAuraPickupManager> Owner;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FAuraConsumedPickup, FAuraConsumedPickupArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FAuraConsumedPickupArray> : public TStructOpsTypeTraitsBase2<FAuraConsumedPickupArray>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/** A target currently inside a pickup and the infinite effects to remove when it leaves */
+struct FAuraPickupOccupant
+{
+	TWeakObjectPtr<AActor> Target;
+	int32 Pickup = INDEX_NONE;
+	TArray<FActiveGameplayEffectHandle, TInlineAllocator<1>> InfiniteHandles;
+	bool bStillOverlapping = false;
+};
+
+/**
+ * Holds large numbers of pickups as compact records instead of one AAuraEffectActor each.
+ * Each pickup type draws through one instanced static mesh, not created on dedicated servers, and the server finds overlaps
+ * every OverlapInterval by looking up the characters' cells in a spatial hash. Effects are applied and removed with the same
+ * policies as AAuraEffectActor. Always relevant and net dormant. Placed pickups load with the level, runtime ones replicate as
+ * grid batches and consumed ones as indices, both fast arrays so each update only sends what changed and clients add or hide
+ * instances one batch at a time instead of rebuilding.
+ */
+UCLASS()
+class AURA_API AAuraPickupManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AAuraPickupManager();
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	/** Adds a pickup at runtime on the server, returns its index */
+	UFUNCTION(BlueprintCallable, Category = "Pickups")
+	int32 AddPickup(int32 Type, const FVector& Location);
+
+	/** Adds Count pickups on a square grid of Columns from Corner on the server, sent to clients as one batch, returns the first index */
+	int32 AddPickupGrid(int32 Type, const FVector& Corner, int32 Columns, int32 Count, float Spacing);
+
+	int32 GetNumPickups() const { return Pickups.Num(); }
+	int32 GetNumTypes() const { return PickupTypes.Num(); }
+
+protected:
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(EditAnywhere, Category = "Pickups")
+	TArray<FAuraPickupType> PickupTypes;
+
+	/** Placed pickups, loaded by clients with the level, followed by those added at runtime */
+	UPROPERTY(EditAnywhere, Category = "Pickups")
+	TArray<FAuraPickupRecord> Pickups;
+
+	/** Spatial hash cell size, raised to the largest pickup radius so only neighbouring cells need checking */
+	UPROPERTY(EditAnywhere, Category = "Pickups")
+	float CellSize = 500.f;
+
+	/** How far above or below a pickup a target's origin may be and still overlap it */
+	UPROPERTY(EditAnywhere, Category = "Pickups")
+	float HeightTolerance = 200.f;
+
+	UPROPERTY(EditAnywhere, Category = "Pickups")
+	float OverlapInterval = 0.1f;
+
+private:
+
+	friend struct FAuraPickupBatch;
+	friend struct FAuraConsumedPickup;
+
+	void AddBatch(const FAuraPickupBatch& Batch);
+	void MarkConsumed(int32 PickupIndex);
+	void SetNumPickups(int32 NumPickups);
+
+	FIntPoint GetCell(const FVector3f& Location) const;
+	void BuildSpatialHash();
+	void AddToSpatialHash(int32 PickupIndex);
+	void RemoveFromSpatialHash(int32 PickupIndex);
+	void GatherTargets(TArray<AActor*>& OutTargets) const;
+
+	void OnOverlap(FAuraPickupOccupant& Occupant);
+	void OnEndOverlap(FAuraPickupOccupant& Occupant);
+	void ApplyEffectToTarget(FAuraPickupOccupant& Occupant, TSubclassOf<UGameplayEffect> GameplayEffectClass);
+	void Consume(int32 PickupIndex);
+
+	void RebuildInstances();
+	void AddInstances(int32 FirstPickup, int32 Count);
+	void HideInstance(int32 PickupIndex);
+	SIZE_T GetBookkeepingSize() const;
+
+	UPROPERTY(Replicated)
+	FAuraPickupBatchArray AddedPickups;
+
+	UPROPERTY(Replicated)
+	FAuraConsumedPickupArray ConsumedPickups;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInstancedStaticMeshComponent>> InstanceComponents;
+
+	// Per pickup, its instance in its type's component
+	TArray<int32> InstanceIndices;
+
+	TBitArray<> Consumed;
+	bool bAnyTypeAppliesToEnemies = false;
+
+	TMap<FIntPoint, TArray<int32>> SpatialHash;
+	TArray<FAuraPickupOccupant> Occupants;
+};
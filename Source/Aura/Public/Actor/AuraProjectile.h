@@ -40,6 +40,7 @@ private:
 	UPROPERTY(EditDefaultsOnly)
 	float LifeSpan = 15.f;
 	void OnHit();
+	void ReleaseLoopingSound();
 	bool bHit = false;
 
 	UPROPERTY(VisibleAnywhere)
@@ -51,6 +51,10 @@ struct FDamageEffectParams
 
 	UPROPERTY()
 	FVector DeathImpulse = FVector::ZeroVector;
+
+	// Pins the seed of this effect's debuff, block and crit rolls, 0 takes the next seed from the source's ability system component
+	UPROPERTY()
+	uint64 RollSeed = 0;
 };
 
 USTRUCT(BlueprintType)
@@ -68,6 +72,7 @@ public:
 	float GetDebuffFrequency() const { return DebuffFrequency; }
 	TSharedPtr<FGameplayTag> GetDamageType() const { return DamageType; }
 	FVector GetDeathImpulse() const { return DeathImpulse; }
+	uint64 GetRollSeed() const { return RollSeed; }
 
 	void SetIsCriticalHit(bool bInIsCriticalHit) { bIsCriticalHit = bInIsCriticalHit; }
 	void SetIsBlockedHit(bool bInIsBlockedHit) { bIsBlockedHit = bInIsBlockedHit; }
@@ -77,6 +82,7 @@ public:
 	void SetDebuffFrequency(float InDebuffFrequency) { DebuffFrequency = InDebuffFrequency; }
 	void SetDamageType(TSharedPtr<FGameplayTag> InDamageType) { DamageType = InDamageType; }
 	void SetDeathImpulse(const FVector& InImpulse) { DeathImpulse = InImpulse; }
+	void SetRollSeed(uint64 InRollSeed) { RollSeed = InRollSeed; }
 
 	/** Returns the actual struct used for serialization, subclasses must override this! */
 	virtual UScriptStruct* GetScriptStruct() const
@@ -124,6 +130,11 @@ protected:
 
 	UPROPERTY()
 	FVector DeathImpulse = FVector::ZeroVector;
+
+	// Seeds the FAuraRandomStream used for this effect's debuff, block and crit rolls, 0 takes one from the source when executed.
+	// Server only and not net serialized, clients do not predict the rolls
+	UPROPERTY()
+	uint64 RollSeed = 0;
 };
 
 template<>
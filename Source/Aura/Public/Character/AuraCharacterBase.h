@@ -17,19 +17,40 @@ class UAnimMontage;
 class UNiagaraSystem;
 class UDebuffNiagaraComponent;
 
+/** Replicated so late joining and newly relevant clients also end up with the corpse state */
+USTRUCT()
+struct FAuraDeathState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	bool bDead = false;
+
+	UPROPERTY()
+	FVector_NetQuantize10 DeathImpulse = FVector::ZeroVector;
+
+	// Server world time
+	UPROPERTY()
+	float DeathTime = 0.f;
+};
+
 UCLASS(Abstract)
 class AURA_API AAuraCharacterBase : public ACharacter, public IAbilitySystemInterface, public ICombatInterface
 {
 	GENERATED_BODY()
 
+	friend class UAuraDissolveSubsystem;
+
 public:
 	AAuraCharacterBase();
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	UAttributeSet* GetAttributeSet() { return AttributeSet; }
+	USkeletalMeshComponent* GetWeapon() const { return Weapon; }
 
 	/** Combat Interface*/
 	virtual UAnimMontage* GetHitReactMontage_Implementation() override;
-	virtual void Die() override;
+	virtual void Die(const FVector& DeathImpulse) override;
 	virtual FVector GetCombatSocketLocation_Implementation(const FGameplayTag& MontageTag) override;
 	virtual bool IsDead_Implementation() const override;
 	virtual AActor* GetAvatar_Implementation() override;
@@ -44,14 +65,29 @@ public:
 
 	FOnASCRegistered OnASCRegistered;
 
-	UFUNCTION(NetMulticast, Reliable)
-	virtual void MulticastHandleDeath();
+	UPROPERTY(ReplicatedUsing = OnRep_DeathState)
+	FAuraDeathState DeathState;
+
+	UFUNCTION()
+	void OnRep_DeathState();
+
+	virtual void HandleDeath();
+
+#if WITH_DEV_AUTOMATION_TESTS
+	/** Times HandleDeath got past its guard, the death tests expect exactly one per death */
+	int32 NumHandledDeaths = 0;
+#endif
+
+	/** Called when the dissolve has finished, releases the corpse's physics */
+	UFUNCTION(BlueprintCallable)
+	void FinishDissolve();
 
 	UPROPERTY(EditAnywhere, Category = "Combat")
 	TArray<FTaggedMontage> AttackMontages;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
 	TObjectPtr<USkeletalMeshComponent> Weapon;
@@ -108,6 +144,22 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	TObjectPtr<UMaterialInstance> WeaponDissolveMaterialInstance;
 
+	/** The dissolve materials read the parameter from custom primitive data, so no material instance is needed per death */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dissolve")
+	bool bDissolveUsesCustomPrimitiveData = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dissolve")
+	FName DissolveParameterName = FName("Dissolve");
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dissolve")
+	float DissolveStartValue = -0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dissolve")
+	float DissolveEndValue = 0.55f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dissolve")
+	float DissolveDuration = 3.f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
 	UNiagaraSystem* BloodEffect;
 
@@ -119,9 +171,17 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Class Defaults")
 	ECharacterClass CharacterClass = ECharacterClass::Warrior;
 
+	/** Looping effect shown while the debuff tag is on this character, spawned by UAuraVFXSubsystem */
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	TMap<FGameplayTag, TObjectPtr<UNiagaraSystem>> DebuffEffects;
+
+	/** Deprecated, kept so the Blueprints and levels that reference it still load. Its system becomes the Debuff.Burn entry in
+	 * DebuffEffects when there is none, and the component itself is never activated */
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<UDebuffNiagaraComponent> BurnDebuffComponent;
 
+	void RegisterDebuffEffects();
+
 private:
 
 	UPROPERTY(EditAnywhere, Category = "Abilities")
@@ -0,0 +1,58 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraCorpseSubsystem.generated.h"
+
+class AAuraCharacterBase;
+class USkeletalMeshComponent;
+
+/**
+ * Keeps ragdoll physics within budget.
+ * Only the newest Aura.Corpse.MaxSimulating corpses simulate, settled ones are frozen in their pose with their bodies removed from
+ * the simulation, corpses beyond Aura.Corpse.MaxCorpses are hidden and their physics released.
+ * Solver cost is reported as the number of simulating ragdoll bodies, the solver's own time is under stat Physics.
+ */
+UCLASS()
+class AURA_API UAuraCorpseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCorpse(AAuraCharacterBase* Character);
+
+	/** Stops simulating and drops the corpse from the budget, e.g. once its dissolve has finished */
+	void ReleaseCorpse(AAuraCharacterBase* Character);
+
+	int32 GetNumSimulatingCorpses() const;
+	int32 GetNumCorpses() const { return Corpses.Num(); }
+
+	/** True while Character is a kept corpse, simulating or frozen, false once it was evicted or released */
+	bool IsCorpse(const AAuraCharacterBase* Character) const;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	struct FAuraCorpse
+	{
+		TWeakObjectPtr<AAuraCharacterBase> Character;
+		float TimeSinceDeath = 0.f;
+		bool bSimulating = true;
+	};
+
+	static void FreezeCorpse(FAuraCorpse& Corpse);
+	static void FreezeMesh(USkeletalMeshComponent* Mesh);
+	static void ReleasePhysics(AAuraCharacterBase* Character);
+
+	// Oldest first
+	TArray<FAuraCorpse> Corpses;
+};
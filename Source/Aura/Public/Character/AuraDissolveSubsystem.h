@@ -0,0 +1,87 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraDissolveSubsystem.generated.h"
+
+class AAuraCharacterBase;
+class UMaterialInstanceDynamic;
+class UMaterialInterface;
+class UMeshComponent;
+
+USTRUCT()
+struct FAuraDissolve
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<AAuraCharacterBase> Character = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UMeshComponent> Mesh = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UMeshComponent> Weapon = nullptr;
+
+	// Null when the dissolve is driven through custom primitive data
+	UPROPERTY()
+	TObjectPtr<UMaterialInstanceDynamic> MeshMID = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInstanceDynamic> WeaponMID = nullptr;
+
+	float Elapsed = 0.f;
+};
+
+/**
+ * Advances every active dissolve from a single native tick.
+ * Characters flagged with bDissolveUsesCustomPrimitiveData are driven through per primitive data and need no material instance,
+ * the rest borrow a MID from a bounded pool that is reused across deaths and wait in a queue while the pool is exhausted.
+ */
+UCLASS()
+class AURA_API UAuraDissolveSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void StartDissolve(AAuraCharacterBase* Character);
+
+	/** Instances driving a dissolve right now, idle pooled ones not included */
+	int32 GetNumLiveMIDs() const { return NumMIDs - FreeMIDs.Num(); }
+
+	/** Every instance the pool owns, live or idle, bounded by Aura.Dissolve.MaxMIDs */
+	int32 GetNumMIDs() const { return NumMIDs; }
+
+	int32 GetNumActiveDissolves() const { return ActiveDissolves.Num(); }
+	int32 GetNumPendingDissolves() const { return PendingDissolves.Num(); }
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	bool TryStartDissolve(AAuraCharacterBase* Character, bool bIgnoreBudget);
+	UMaterialInstanceDynamic* AcquireMID(UMaterialInterface* ParentMaterial, bool bIgnoreBudget);
+	void ReleaseMID(UMaterialInstanceDynamic* MID, UMeshComponent* MeshComponent);
+	void FinishDissolve(FAuraDissolve& Dissolve);
+	static void ApplyDissolveValue(const FAuraDissolve& Dissolve, FName ParameterName, float Value);
+
+	UPROPERTY()
+	TArray<FAuraDissolve> ActiveDissolves;
+
+	// Waiting for a MID, oldest first
+	UPROPERTY()
+	TArray<TObjectPtr<AAuraCharacterBase>> PendingDissolves;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UMaterialInstanceDynamic>> FreeMIDs;
+
+	int32 NumMIDs = 0;
+};
@@ -5,6 +5,8 @@
 #include "Character/AuraCharacterBase.h"
 #include "UI/WidgetController/OverlayWidgetController.h"
 #include "Interaction/EnemyInterface.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "Character/AuraSignificanceSubsystem.h"
 #include "AuraEnemy.generated.h"
 
 class UWidgetComponent;
@@ -30,7 +32,7 @@ public:
 
 	/** Combat Interface */
 	virtual int32 GetPlayerLevel_Implementation() override;
-	virtual void Die() override;
+	virtual void Die(const FVector& DeathImpulse) override;
 	virtual void SetCombatTarget_Implementation(AActor* InCombatTarget) override;
 	virtual AActor* GetCombatTarget_Implementation() const override;
 	/** End Combat Interface */
@@ -55,8 +57,23 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Combat")
 	TObjectPtr<AActor> CombatTarget;
 
+	/** Scales movement, animation, behaviour tree, health bar and debuff visual updates */
+	void SetSignificance(EAuraSignificance NewSignificance);
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Significance")
+	EAuraSignificance Significance = EAuraSignificance::High;
+
+	void SetLevel(int32 InLevel) { Level = InLevel; }
+
+	/** Set before FinishSpawning to skip default attributes and startup abilities in BeginPlay, the spawner runs them later */
+	bool bDeferStartupInitialisation = false;
+
+	/** Applies the default attributes and grants the startup abilities skipped by bDeferStartupInitialisation */
+	void FinishStartupInitialisation();
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void InitAbilityActorInfo() override;
 
 	virtual void InitialiseDefaultAttributes() const override;
@@ -67,10 +84,22 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TObjectPtr<UWidgetComponent> HealthBar;
 
+	/** When false the HealthBar component is removed and the HUD draws this enemy's bar in its batched pass */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI")
+	bool bUseWidgetHealthBar = true;
+
+	/** Height above the actor location of the HUD drawn health bar */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI")
+	float HealthBarHeightOffset = 120.f;
+
 	UPROPERTY(EditAnywhere, Category = "AI")
 	TObjectPtr<UBehaviorTree> BehaviorTree;
 
 	UPROPERTY()
 	TObjectPtr<AAuraAIController> AuraAIController;
 
+	// Resolved once after the blackboard is initialised, avoids FName lookups on every hit react
+	FBlackboard::FKey HitReactingKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey DeadKey = FBlackboard::InvalidKey;
+
 };
@@ -0,0 +1,52 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraSignificanceSubsystem.generated.h"
+
+class AAuraEnemy;
+
+UENUM(BlueprintType)
+enum class EAuraSignificance : uint8
+{
+	High,
+	Medium,
+	Low
+};
+
+/**
+ * Scores every AAuraEnemy by distance to the nearest player and by whether it was recently rendered,
+ * then lets the enemy scale its movement, animation, behaviour tree, health bar and debuff visuals to match.
+ * Dead enemies are always Low, but their ragdoll meshes keep ticking every frame.
+ * Aura.Significance.Debug draws the current bucket of every enemy.
+ */
+UCLASS()
+class AURA_API UAuraSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AAuraEnemy* Enemy);
+	void UnregisterEnemy(AAuraEnemy* Enemy);
+
+	/** Tick interval used for components of an enemy in the given bucket */
+	static float GetTickInterval(EAuraSignificance Significance);
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	EAuraSignificance ScoreEnemy(const AAuraEnemy* Enemy, const TArray<FVector, TInlineAllocator<4>>& ViewerLocations, bool bCanUseVisibility) const;
+
+	TArray<TWeakObjectPtr<AAuraEnemy>> Enemies;
+
+	float TimeSinceUpdate = 0.f;
+};
@@ -0,0 +1,32 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AuraCombatLogCommandlet.generated.h"
+
+struct FAuraCombatLogRecord;
+
+/**
+ * Filters, aggregates and replays combat logs written by UAuraCombatLogSubsystem.
+ * UnrealEditor-Cmd Aura.uproject -run=AuraCombatLog -Log=<File or Dir> [-Type=Hit] [-Source=<Id>] [-Target=<Id>]
+ *     [-DamageType=Damage.Fire] [-From=<Seconds>] [-To=<Seconds>] [-Csv=<File>] [-Replay] [-Tolerance=0.01]
+ * -Replay re-rolls block and crit from each hit's seed against its recorded chances, re-runs it through FAuraDamageKernel and
+ * reports hits whose rolls or damage differ, which flags roll order, formula changes and server/offline desyncs.
+ * Damage types resolve through this build's gameplay tags.
+ */
+UCLASS()
+class AURA_API UAuraCombatLogCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UAuraCombatLogCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** The damage FAuraDamageKernel gives for a recorded hit with block and crit re-rolled from its seed, false in bOutRollsMatch if either differs from the log */
+	static float ReplayHit(const FAuraCombatLogRecord& Record, bool& bOutRollsMatch);
+};
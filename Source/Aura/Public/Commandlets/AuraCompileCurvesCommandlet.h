@@ -0,0 +1,32 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AuraCompileCurvesCommandlet.generated.h"
+
+class UCurveTable;
+
+/**
+ * Validates the CT_* curve table sources and compiles them into Content/CompiledCurves for FAuraCompiledCurves.
+ * UnrealEditor-Cmd Aura.uproject -run=AuraCompileCurves [-Source=<Dir>] [-Tables=/Game/A,/Game/B] [-MaxLevel=N] [-ValidateOnly]
+ * Source defaults to the project's Data directory. Each source is imported as linear and must match the curve table asset of the same
+ * name at every whole level, so sources for cubic or constant assets hold one key per level. Names shared by several assets are errors,
+ * compile those with -Tables. Files are written under the asset's package path. -ValidateOnly also fails on compiled files whose
+ * asset was edited since, run it before cooking. Returns 1 if any table fails validation.
+ */
+UCLASS()
+class AURA_API UAuraCompileCurvesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UAuraCompileCurvesCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Imports a CT_* JSON or CSV source into a transient curve table, null if it has problems */
+	static UCurveTable* ImportSourceFile(const FString& Filename, TArray<FString>& OutErrors);
+};
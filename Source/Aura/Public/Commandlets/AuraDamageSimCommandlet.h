@@ -0,0 +1,33 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AuraDamageSimCommandlet.generated.h"
+
+class UCurveTable;
+
+/**
+ * Monte Carlo damage balancing through FAuraDamageKernel, sweeping every class matchup over a set of levels.
+ * UnrealEditor-Cmd Aura.uproject -run=AuraDamageSim [-Source=<Dir>] [-Ability=Abilities.Firebolt] [-DamageType=Fire]
+ *     [-Levels=1,5,10,20,40] [-Hits=100000] [-HitsPerSecond=1] [-ClassInfo=<CharacterClassInfoPath>] [-Seed=N]
+ * Primary attributes come from CT_PrimaryAttributes_<Class>, ability damage from CT_Damage and the coefficients from
+ * CT_DamageCalculationCoefficients, all in the source directory. Secondary attributes, resistances and max health are derived
+ * from the primaries by applying the class info's secondary attribute effect, so they follow its modifiers and MMCs.
+ */
+UCLASS()
+class AURA_API UAuraDamageSimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UAuraDamageSimCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	UCurveTable* LoadSourceTable(const FString& SourceDirectory, const FString& TableName, TArray<FString>& OutErrors) const;
+};
@@ -0,0 +1,66 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+class USoundClass;
+
+/**
+ * Central player for combat one shots and projectile loops.
+ * Identical sounds fired close together are merged into one voice, every sound class has its own voice budget,
+ * and looping projectile audio comes from a pool of reusable audio components.
+ */
+UCLASS()
+class AURA_API UAuraAudioSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+	/** Returns true if a voice was actually started */
+	bool PlayCombatSound(USoundBase* Sound, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	UAudioComponent* AcquireLoopingSound(USoundBase* Sound, USceneComponent* AttachToComponent);
+	void ReleaseLoopingSound(UAudioComponent* AudioComponent);
+
+	int32 GetVoicesRequested() const { return VoicesRequested; }
+	int32 GetVoicesPlayed() const { return VoicesPlayed; }
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	struct FAuraActiveVoice
+	{
+		TWeakObjectPtr<USoundBase> Sound;
+		TWeakObjectPtr<USoundClass> SoundClass;
+		FVector Location = FVector::ZeroVector;
+		double StartTime = 0.0;
+		double EndTime = 0.0;
+	};
+
+	bool ShouldPlay() const;
+
+	TArray<FAuraActiveVoice> ActiveVoices;
+
+	UPROPERTY()
+	TObjectPtr<AActor> PoolOwner;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UAudioComponent>> FreeLoopingComponents;
+
+	int32 NumActiveLoops = 0;
+	int32 VoicesRequested = 0;
+	int32 VoicesPlayed = 0;
+};
@@ -0,0 +1,121 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+enum class EAuraCombatLogRecordType : uint8
+{
+	Hit,
+	Debuff,
+	Death,
+	XPGrant,
+	LevelUp
+};
+
+enum class EAuraCombatLogFlags : uint8
+{
+	None = 0,
+	BlockedHit = 1 << 0,
+	CriticalHit = 1 << 1,
+	SuccessfulDebuff = 1 << 2
+};
+ENUM_CLASS_FLAGS(EAuraCombatLogFlags);
+
+/** Inputs FAuraDamageKernel takes after resistances and the chances the rolls were made against, enough to re-run a hit offline */
+struct FAuraCombatLogHit
+{
+	float Damage;
+	float TargetBlockChance;
+	float TargetArmour;
+	float SourceArmourPenetration;
+	float ArmourPenetrationCoefficient;
+	float EffectiveArmourCoefficient;
+	float SourceCriticalHitDamage;
+	float EffectiveCriticalHitChance;
+};
+
+struct FAuraCombatLogDebuff
+{
+	float Duration;
+	float Frequency;
+};
+
+/**
+ * One fixed size combat log record. Ids are ability system component unique ids, stable for the session the log came from.
+ * Value is the final damage of a hit, damage per tick of a debuff, XP granted or the new level.
+ * DamageType is a gameplay tag net index, only meaningful with the tag tables of the build that wrote the log.
+ */
+struct FAuraCombatLogRecord
+{
+	double Time;
+	uint64 RollSeed;
+	uint32 SourceId;
+	uint32 TargetId;
+	EAuraCombatLogRecordType Type;
+	EAuraCombatLogFlags Flags;
+	uint16 DamageType;
+	uint8 SourceClass;
+	uint8 TargetClass;
+	uint8 SourceLevel;
+	uint8 TargetLevel;
+	float Value;
+
+	union
+	{
+		FAuraCombatLogHit Hit;
+		FAuraCombatLogDebuff Debuff;
+	};
+};
+static_assert(sizeof(FAuraCombatLogRecord) == 72, "Combat log records are a fixed 72 bytes, bump FAuraCombatLog::Version when the layout changes");
+
+/**
+ * Reads a combat log written by UAuraCombatLogSubsystem through a memory mapping.
+ * A trailing partial record, from a server that stopped mid-write, is ignored.
+ */
+class AURA_API FAuraCombatLog
+{
+public:
+
+	static constexpr uint32 Magic = 0x4C435541; // 'AUCL'
+	static constexpr uint32 Version = 2;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 RecordSize;
+		uint32 Reserved;
+		int64 StartTicks;
+		int64 Reserved2;
+	};
+
+	static FHeader MakeHeader();
+
+	FAuraCombatLog();
+	~FAuraCombatLog();
+
+	bool Load(const FString& Filename);
+
+	TConstArrayView<FAuraCombatLogRecord> GetRecords() const { return TConstArrayView<FAuraCombatLogRecord>(Records, NumRecords); }
+	FDateTime GetStartTime() const { return FDateTime(StartTicks); }
+
+	static const TCHAR* LexToString(EAuraCombatLogRecordType Type);
+
+private:
+
+	bool Parse(const uint8* Data, int64 Size);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Used instead of the mapping on platforms that cannot map files
+	TArray<uint8> LoadedBytes;
+
+	const FAuraCombatLogRecord* Records = nullptr;
+	int32 NumRecords = 0;
+	int64 StartTicks = 0;
+};
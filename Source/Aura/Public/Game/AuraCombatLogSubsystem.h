@@ -0,0 +1,59 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Game/AuraCombatLog.h"
+#include "Tasks/Task.h"
+#include "AuraCombatLogSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class FAuraCombatLogWriter;
+struct FGameplayTag;
+
+/**
+ * Server side recorder appending fixed size hit, debuff, death, XP and level up records to Saved/CombatLogs.
+ * Records are buffered on the game thread and handed to a background task in batches, which rolls to a new file
+ * past Aura.CombatLog.MaxFileMB. Only the newest Aura.CombatLog.MaxFiles logs are kept. Read the logs back with FAuraCombatLog or the AuraCombatLog commandlet.
+ */
+UCLASS()
+class AURA_API UAuraCombatLogSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	void RecordHit(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, const FGameplayTag& DamageType, uint64 RollSeed,
+		const FAuraCombatLogHit& Hit, EAuraCombatLogFlags Flags, float FinalDamage);
+	void RecordDebuff(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC, const FGameplayTag& DamageType,
+		float DamagePerTick, float Duration, float Frequency);
+	void RecordDeath(const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC);
+	void RecordXPGrant(const AActor* Recipient, int32 XP);
+	void RecordLevelUp(const AActor* Recipient, int32 NewLevel);
+
+	/** Hands every buffered record to the writer */
+	void Flush();
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	FAuraCombatLogRecord& AddRecord(EAuraCombatLogRecordType Type, const UAbilitySystemComponent* SourceASC, const UAbilitySystemComponent* TargetASC);
+
+	TArray<FAuraCombatLogRecord> PendingRecords;
+	TSharedPtr<FAuraCombatLogWriter, ESPMode::ThreadSafe> Writer;
+
+	// Each batch is written after the previous one so records stay in order
+	UE::Tasks::FTask LastWrite;
+	double LastFlushTime = 0.0;
+};
@@ -0,0 +1,106 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "AuraReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_PlayerStateFrequencyLimiter;
+
+/** Which node an actor class is routed to */
+UENUM()
+enum class EAuraClassRepNodeMapping : uint8
+{
+	NotRouted,					// Only replicated through the owning connection's node, e.g. player controllers
+	RelevantAllConnections,		// Always relevant, e.g. the game state
+	Spatialize_Static,			// Grid, never moves
+	Spatialize_Dynamic,			// Grid, moves and is re-bucketed every frame
+	Spatialize_Dormancy,		// Grid, static while dormant and dynamic while awake
+	Projectile,					// UAuraReplicationGraphNode_Projectiles
+	PlayerState					// Frequency limited for everyone, every frame for the owner
+};
+
+/**
+ * Replicates short-lived projectiles by a distance check against the viewers instead of the grid,
+ * so they never pay for being added to, moved between and removed from grid cells.
+ */
+UCLASS()
+class AURA_API UAuraReplicationGraphNode_Projectiles : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	float CullDistanceSquared = 0.f;
+
+private:
+
+	TArray<AActor*> Projectiles;
+
+	// Gathered lists are kept per connection as they are referenced until that connection has replicated
+	TMap<UNetReplicationGraphConnection*, FActorRepListRefView> GatheredLists;
+};
+
+/** Adds the connection's own player state every frame on top of its view target and controller */
+UCLASS()
+class AURA_API UAuraReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+
+	FActorRepListRefView OwnerActorList;
+};
+
+/**
+ * Server replication graph. Enemies and player characters are spatialised in a 2D grid, effect actors use the grid's dormancy
+ * handling so idle pickups cost nothing until they wake, projectiles go through their own distance checked node and player states
+ * replicate to other players at a limited rate but every frame to their owner. Selected in DefaultEngine.ini,
+ * see Scripts/aura_soak.py --no-repgraph to compare against the default relevancy.
+ */
+UCLASS(Transient)
+class AURA_API UAuraReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	UAuraReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+	UPROPERTY()
+	TObjectPtr<UAuraReplicationGraphNode_Projectiles> ProjectileNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_PlayerStateFrequencyLimiter> PlayerStateNode;
+
+private:
+
+	EAuraClassRepNodeMapping GetMappingPolicy(const UClass* Class);
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, const UClass* Class, bool bSpatialize) const;
+
+	TClassMap<EAuraClassRepNodeMapping> ClassRepNodePolicies;
+};
@@ -0,0 +1,80 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraSoakStatsSubsystem.generated.h"
+
+class UNetDriver;
+class UFunction;
+struct FOutParmRec;
+struct FFrame;
+
+/**
+ * Samples network, frame and GC stats into CSV files for soak tests, enabled with -AuraSoakCsv=<File>.
+ * <File> gets one row per Aura.Soak.SampleSeconds with frame times, the net driver's TickFlush (replication) time,
+ * bandwidth totals and bytes per connection, RPCs, GC and memory,
+ * <File>_Connections.csv the bandwidth and ping of every connection and <File>_RPCs.csv the RPCs sent per function at the end.
+ * -AuraSoakDuration=<Seconds> exits cleanly once the time is up so the files are complete.
+ * Runs on the dedicated server and on -AuraBot clients alike, see Scripts/aura_soak.py.
+ */
+UCLASS()
+class AURA_API UAuraSoakStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void WriteSample(double Now);
+	void WriteRPCSummary();
+	void BindRPCCounter();
+	void OnSendRPC(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject, bool& bBlockSendRPC);
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	void OnTickFlush(float DeltaSeconds);
+	void OnPostTickFlush();
+
+	FString CsvBaseFilename;
+	TUniquePtr<FArchive> SampleFile;
+	TUniquePtr<FArchive> ConnectionFile;
+
+	TWeakObjectPtr<UNetDriver> BoundNetDriver;
+	bool bCountingRPCs = false;
+	TMap<FName, int64> RPCCounts;
+	int64 SampleRPCs = 0;
+
+	float Duration = 0.f;
+	double StartTime = 0.0;
+	double LastSampleTime = 0.0;
+
+	// Accumulated over the current sample
+	int32 SampleFrames = 0;
+	double SampleFrameMs = 0.0;
+	double MaxFrameMs = 0.0;
+	double SampleGameThreadMs = 0.0;
+	double SampleReplicationMs = 0.0;
+	double TickFlushStartTime = 0.0;
+	int32 SampleGCs = 0;
+	double SampleGCMs = 0.0;
+	double GCStartTime = 0.0;
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+	FDelegateHandle TickFlushHandle;
+	FDelegateHandle PostTickFlushHandle;
+};
@@ -0,0 +1,123 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProfilingDebugging/Histogram.h"
+#include "AuraSpawnSubsystem.generated.h"
+
+class AAuraEnemy;
+class AAuraEffectActor;
+class AAuraPickupManager;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEnemySpawned, AAuraEnemy*, Enemy);
+
+USTRUCT()
+struct FAuraSpawnRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AAuraEnemy> EnemyClass;
+
+	UPROPERTY()
+	FTransform Transform;
+
+	UPROPERTY()
+	int32 Level = 1;
+
+	double QueueTime = 0.0;
+};
+
+USTRUCT()
+struct FAuraPendingInit
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<AAuraEnemy> Enemy = nullptr;
+
+	double QueueTime = 0.0;
+};
+
+USTRUCT()
+struct FAuraPrewarmedEnemies
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AAuraEnemy>> Enemies;
+
+	UPROPERTY()
+	int32 TargetCount = 0;
+};
+
+/**
+ * Server side enemy spawner that spreads spawning and startup initialisation across frames within Aura.Spawn.BudgetMs.
+ * Spawning and initialisation (default attributes and startup abilities) are separate work items, and enemies stay hidden,
+ * without collision, damage or AI until they are initialised. Idle frames pre-warm hidden enemies of requested classes so a wave can reuse them.
+ * Aura.Spawn.DumpLatency logs the queue-to-ready latency histogram. Aura.Spawn.Enemies, or -AuraSpawnEnemies=<Count>
+ * -AuraSpawnEnemyClass=<ClassPath> [-AuraSpawnRadius=<Radius>] on the command line, queues a crowd for load tests
+ * and -AuraSpawnPickups=<Count> -AuraSpawnPickupClass=<ClassPath> [-AuraSpawnPickupSpacing=<Spacing>] fills the map with pickups,
+ * or -AuraSpawnInstancedPickups=<Count> with records in the map's AAuraPickupManager.
+ */
+UCLASS()
+class AURA_API UAuraSpawnSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(BlueprintCallable, Category = "Spawning")
+	void QueueSpawn(TSubclassOf<AAuraEnemy> EnemyClass, const FTransform& Transform, int32 Level = 1);
+
+	/** Queues Count enemies spread over a disc of Radius around the first player start, for load tests */
+	void QueueCrowd(TSubclassOf<AAuraEnemy> EnemyClass, int32 Count, float Radius, int32 Level = 1);
+
+	/** Spawns Count pickups straight away on a square grid around the first player start, for load tests */
+	void SpawnPickupField(TSubclassOf<AAuraEffectActor> PickupClass, int32 Count, float Spacing);
+
+	/** The same field as records of PickupManager's first pickup type */
+	void AddInstancedPickupField(AAuraPickupManager* PickupManager, int32 Count, float Spacing);
+
+	/** Keeps Count hidden enemies of EnemyClass ready, filled during frames with no queued work */
+	UFUNCTION(BlueprintCallable, Category = "Spawning")
+	void RequestPrewarm(TSubclassOf<AAuraEnemy> EnemyClass, int32 Count);
+
+	UPROPERTY(BlueprintAssignable, Category = "Spawning")
+	FOnEnemySpawned OnEnemySpawned;
+
+	int32 GetNumQueued() const { return PendingSpawns.Num() + PendingInits.Num(); }
+	void DumpLatencyHistogram() const;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	AAuraEnemy* SpawnEnemy(TSubclassOf<AAuraEnemy> EnemyClass, const FTransform& Transform, int32 Level, bool bPrewarm) const;
+	AAuraEnemy* TakePrewarmed(TSubclassOf<AAuraEnemy> EnemyClass, const FTransform& Transform, int32 Level);
+	bool PrewarmOne();
+	static void SetEnemyActive(AAuraEnemy* Enemy, bool bActive);
+	FVector GetFieldCorner(int32 Count, float Spacing, int32& OutColumns) const;
+	void ForEachFieldLocation(int32 Count, float Spacing, TFunctionRef<void(const FVector&)> Callback) const;
+
+	UPROPERTY()
+	TArray<FAuraSpawnRequest> PendingSpawns;
+
+	UPROPERTY()
+	TArray<FAuraPendingInit> PendingInits;
+
+	UPROPERTY()
+	TMap<TSubclassOf<AAuraEnemy>, FAuraPrewarmedEnemies> Prewarmed;
+
+	// Seconds from QueueSpawn until the enemy is initialised
+	FHistogram SpawnLatencyHistogram;
+};
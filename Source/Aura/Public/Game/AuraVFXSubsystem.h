@@ -0,0 +1,61 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "AuraVFXSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UNiagaraComponent;
+class UNiagaraSystem;
+
+/**
+ * Central spawner for combat Niagara effects.
+ * Impacts come from the Niagara component pool, are culled by distance to the local camera and limited per frame.
+ * Debuff visuals are attached from the pool while the owner's ASC has the debuff tag, instead of a component per character.
+ */
+UCLASS()
+class AURA_API UAuraVFXSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	UNiagaraComponent* SpawnImpactEffect(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	void RegisterDebuffVisuals(AActor* Owner, UAbilitySystemComponent* ASC, const TMap<FGameplayTag, TObjectPtr<UNiagaraSystem>>& DebuffEffects);
+	void ClearDebuffVisuals(AActor* Owner);
+
+	/** Clears the owner's debuff visuals and stops listening for its debuff tags */
+	void UnregisterDebuffVisuals(AActor* Owner);
+
+	/** Hides and pauses the owner's debuff visuals, e.g. while it is of low significance */
+	void SetDebuffVisualsSuppressed(AActor* Owner, bool bSuppressed);
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void DebuffTagChanged(const FGameplayTag CallbackTag, int32 NewCount, TWeakObjectPtr<AActor> Owner);
+	bool IsCulled(const FVector& Location) const;
+
+	struct FAuraDebuffVisuals
+	{
+		TMap<FGameplayTag, TWeakObjectPtr<UNiagaraSystem>> Systems;
+		TMap<FGameplayTag, TWeakObjectPtr<UNiagaraComponent>> ActiveComponents;
+		TMap<FGameplayTag, FDelegateHandle> TagEventHandles;
+		TWeakObjectPtr<UAbilitySystemComponent> ASC;
+		bool bSuppressed = false;
+	};
+
+	TMap<TWeakObjectPtr<AActor>, FAuraDebuffVisuals> DebuffVisuals;
+
+	int32 SpawnsThisFrame = 0;
+};
@@ -0,0 +1,47 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "AuraBotSubsystem.generated.h"
+
+class AAuraPlayerController;
+class UAuraAbilitySystemComponent;
+
+/**
+ * Drives the local AAuraPlayerController of a client started with -AuraBot, for soak testing with headless clients.
+ * Every Aura.Bot.ActionInterval seconds it clicks to move, casts FireBolt at the nearest enemy, spends a spell point or equips
+ * a spell from the spell menu, or upgrades an attribute, going through the same controller and ability system calls as a player.
+ * -AuraBotSeed=N makes the choices repeatable.
+ */
+UCLASS()
+class AURA_API UAuraBotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void MoveRandomly(AAuraPlayerController* PC);
+	void CastFireBolt(AAuraPlayerController* PC, UAuraAbilitySystemComponent* ASC);
+	void EquipSpell(UAuraAbilitySystemComponent* ASC);
+	void UpgradeAttribute(UAuraAbilitySystemComponent* ASC);
+
+	// Clicked on the tick after the cursor override is set, once CursorTrace has picked up the new target
+	FGameplayTag PendingClickInputTag;
+
+	float TimeUntilNextAction = 0.f;
+	FRandomStream RandomStream;
+};
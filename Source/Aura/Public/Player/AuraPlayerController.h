@@ -28,6 +28,16 @@ public:
 	UFUNCTION(Client, Reliable)
 	void ShowDamageNumber(float DamageAmount, ACharacter* TargetCharacter, bool bBlockedHit, bool bCriticalHit);
 
+	/** Used instead of tracing under the mouse, lets bots on headless clients aim click-to-move and spells */
+	void SetCursorHitOverride(const FHitResult& HitResult);
+	void ClearCursorHitOverride() { bCursorHitOverride = false; }
+
+	/** The hit under the mouse cursor, or the override when one is set */
+	void GetCursorHitResult(FHitResult& OutHitResult) const;
+
+	/** Presses, holds and releases InputTag within one frame, as a single click or key press would */
+	void SimulateAbilityInputClick(const FGameplayTag& InputTag);
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void SetupInputComponent() override;
@@ -58,6 +68,9 @@ private:
 
 	FHitResult CursorHit;
 
+	FHitResult CursorHitOverride;
+	bool bCursorHitOverride = false;
+
 	void AbilityInputTagPressed(FGameplayTag InputTag);
 	void AbilityInputTagReleased(FGameplayTag InputTag);
 	void AbilityInputTagHeld(FGameplayTag InputTag);
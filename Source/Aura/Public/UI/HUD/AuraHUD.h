@@ -31,8 +31,26 @@ public:
 
 	void InitOverlay(APlayerController* PC, APlayerState* PS, UAbilitySystemComponent* ASC, UAttributeSet* AS);
 
+	virtual void DrawHUD() override;
+
 protected:
 
+	/** Draws every visible, recently damaged bar from UAuraHealthBarSubsystem in one pass */
+	void DrawHealthBars();
+
+	UPROPERTY(EditAnywhere, Category = "Health Bars")
+	FVector2D HealthBarSize = FVector2D(60.f, 6.f);
+
+	UPROPERTY(EditAnywhere, Category = "Health Bars")
+	FLinearColor HealthBarColour = FLinearColor(0.8f, 0.05f, 0.05f, 1.f);
+
+	UPROPERTY(EditAnywhere, Category = "Health Bars")
+	FLinearColor HealthBarBackgroundColour = FLinearColor(0.f, 0.f, 0.f, 0.6f);
+
+	/** Seconds a bar stays up after its owner last took damage */
+	UPROPERTY(EditAnywhere, Category = "Health Bars")
+	float HealthBarDisplayTime = 3.f;
+
 private:
 
 	UPROPERTY()
@@ -0,0 +1,45 @@
+// Copyright Adam Thomas
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraHealthBarSubsystem.generated.h"
+
+struct FAuraHealthBarEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+	float Health = 0.f;
+	float MaxHealth = 0.f;
+	float HeightOffset = 0.f;
+	float LastDamageTime = -1.f;
+};
+
+/**
+ * Compact table of enemy health read by AAuraHUD, which draws all health bars in one pass
+ * instead of a widget component per enemy.
+ */
+UCLASS()
+class AURA_API UAuraHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void Register(AActor* Actor, float HeightOffset, float Health, float MaxHealth);
+	void Unregister(AActor* Actor);
+
+	void SetHealth(AActor* Actor, float Health);
+	void SetMaxHealth(AActor* Actor, float MaxHealth);
+
+	const TArray<FAuraHealthBarEntry>& GetEntries() const { return Entries; }
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	TArray<FAuraHealthBarEntry> Entries;
+	TMap<TWeakObjectPtr<AActor>, int32> EntryIndices;
+};